@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+
+namespace vca {
+
+// A queue that connects two stages of the CLI which run in different threads.
+// The producing stage calls finish() once it is done. The consuming stage then gets the
+// remaining items before pop() returns an empty optional.
+template<class T>
+class PipelineQueue
+{
+public:
+    // If the queue holds this many items, push will wait until there is space. 0 means no limit.
+    PipelineQueue(size_t maximumSize) : maximumSize(maximumSize) {}
+
+    // Push an item to the queue. Wait if the queue is full.
+    // Returns false if the queue was aborted.
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(this->accessMutex);
+        this->popCV.wait(lock, [this]() {
+            return this->maximumSize == 0 || this->items.size() < this->maximumSize
+                   || this->aborted;
+        });
+
+        if (this->aborted)
+            return false;
+
+        this->items.push(std::move(item));
+        this->pushCV.notify_one();
+        return true;
+    }
+
+    // Get an item. If the queue is empty, wait until an item is pushed.
+    // Will return empty opt if the queue is finished and empty or if it was aborted.
+    std::optional<T> pop()
+    {
+        std::unique_lock<std::mutex> lock(this->accessMutex);
+        this->pushCV.wait(lock, [this]() {
+            return !this->items.empty() || this->finished || this->aborted;
+        });
+
+        if (this->aborted || this->items.empty())
+            return {};
+
+        auto item = std::move(this->items.front());
+        this->items.pop();
+        this->popCV.notify_one();
+        return item;
+    }
+
+    // Get an item if there is one. Never waits.
+    std::optional<T> tryPop()
+    {
+        std::unique_lock<std::mutex> lock(this->accessMutex);
+        if (this->aborted || this->items.empty())
+            return {};
+
+        auto item = std::move(this->items.front());
+        this->items.pop();
+        this->popCV.notify_one();
+        return item;
+    }
+
+    // No more items will be pushed
+    void finish()
+    {
+        std::unique_lock<std::mutex> lock(this->accessMutex);
+        this->finished = true;
+        this->pushCV.notify_all();
+    }
+
+    // Stop both stages. Items that are still in the queue are dropped by the consumer.
+    void abort()
+    {
+        std::unique_lock<std::mutex> lock(this->accessMutex);
+        this->aborted = true;
+        this->pushCV.notify_all();
+        this->popCV.notify_all();
+    }
+
+private:
+    std::queue<T> items;
+    std::mutex accessMutex;
+    std::condition_variable pushCV;
+    std::condition_variable popCV;
+
+    size_t maximumSize{};
+    bool finished{};
+    bool aborted{};
+};
+
+} // namespace vca
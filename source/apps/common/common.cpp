@@ -30,30 +30,44 @@ FrameWithData::FrameWithData(const vca_frame_info &frameInfo)
     const auto colorspace = frameInfo.colorspace;
     auto pixelbytes       = frameInfo.bitDepth > 8 ? 2u : 1u;
 
-    size_t planeSizeBytes[3] = {0, 0, 0};
     for (int i = 0; i < vca_cli_csps.at(colorspace).planes; i++)
     {
-        uint32_t w        = frameInfo.width >> vca_cli_csps.at(colorspace).width[i];
-        uint32_t h        = frameInfo.height >> vca_cli_csps.at(colorspace).height[i];
-        planeSizeBytes[i] = w * h * pixelbytes;
+        uint32_t w              = frameInfo.width >> vca_cli_csps.at(colorspace).width[i];
+        uint32_t h              = frameInfo.height >> vca_cli_csps.at(colorspace).height[i];
+        this->planeSizeBytes[i] = w * h * pixelbytes;
+        this->frameSizeBytes += this->planeSizeBytes[i];
     }
 
-    const auto frameSizeBytes = planeSizeBytes[0] + planeSizeBytes[1] + planeSizeBytes[2];
-    if (this->data.size() < frameSizeBytes)
-        this->data.resize(frameSizeBytes);
+    if (this->data.size() < this->frameSizeBytes)
+        this->data.resize(this->frameSizeBytes);
 
-    this->vcaFrame.planes[0] = this->data.data();
-    this->vcaFrame.stride[0] = frameInfo.width;
+    this->vcaFrame.stride[0] = frameInfo.width * pixelbytes;
 
     if (vca_cli_csps.at(colorspace).planes > 1)
     {
-        uint32_t widthChroma  = frameInfo.width >> vca_cli_csps.at(colorspace).width[1];
-        uint32_t heightChroma = frameInfo.height >> vca_cli_csps.at(colorspace).height[1];
+        uint32_t widthChroma     = frameInfo.width >> vca_cli_csps.at(colorspace).width[1];
+        this->vcaFrame.stride[1] = widthChroma * pixelbytes;
+        this->vcaFrame.stride[2] = widthChroma * pixelbytes;
+    }
+
+    this->setPlanePointers(this->data.data());
+}
+
+void FrameWithData::setExternalData(const uint8_t *externalData)
+{
+    if (externalData == nullptr)
+        this->setPlanePointers(this->data.data());
+    else
+        this->setPlanePointers((uint8_t *) (externalData));
+}
 
-        this->vcaFrame.planes[1] = this->data.data() + planeSizeBytes[0];
-        this->vcaFrame.planes[2] = this->data.data() + planeSizeBytes[0] + planeSizeBytes[1];
-        this->vcaFrame.stride[1] = widthChroma;
-        this->vcaFrame.stride[2] = widthChroma;
+void FrameWithData::setPlanePointers(uint8_t *frameData)
+{
+    this->vcaFrame.planes[0] = frameData;
+    if (vca_cli_csps.at(this->vcaFrame.info.colorspace).planes > 1)
+    {
+        this->vcaFrame.planes[1] = frameData + this->planeSizeBytes[0];
+        this->vcaFrame.planes[2] = frameData + this->planeSizeBytes[0] + this->planeSizeBytes[1];
     }
 }
 
@@ -36,19 +36,28 @@ public:
 
     uint8_t *getData() const
     {
-        return (uint8_t *) (this->data.data());
+        return this->vcaFrame.planes[0];
     }
     size_t getFrameSize() const
     {
-        return this->data.size();
+        return this->frameSizeBytes;
     }
     vca_frame *getFrame()
     {
         return &this->vcaFrame;
     }
 
+    // Let the planes point to data that is owned by someone else (e.g. a memory mapped file)
+    // instead of the own buffer. The data must not be written. Use nullptr to switch back to
+    // the own buffer.
+    void setExternalData(const uint8_t *externalData);
+
 private:
+    void setPlanePointers(uint8_t *frameData);
+
     std::vector<uint8_t> data;
+    size_t planeSizeBytes[3]{};
+    size_t frameSizeBytes{};
     vca_frame vcaFrame;
 };
 
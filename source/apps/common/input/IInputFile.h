@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "MappedFile.h"
+
 #include <common/common.h>
 #include <lib/vcaLib.h>
 
@@ -28,7 +30,16 @@
 #define MIN_FRAME_HEIGHT 64
 #define MAX_FRAME_HEIGHT 4320
 
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <iostream>
+#include <memory>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
 
 namespace vca {
 
@@ -38,12 +49,79 @@ protected:
     vca_frame_info frameInfo{};
     unsigned frameCount{};
 
-    std::ifstream input;
+    std::ifstream file;
+    // Reads from the file or from stdin. Stdin can not seek and the size of it is unknown.
+    std::istream input{nullptr};
+    bool readFromStdin{};
+
+    // Open the given file or stdin if the name is "-"
+    bool openInput(const std::string &fileName)
+    {
+        if (fileName == "-")
+        {
+#ifdef _WIN32
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            std::setvbuf(stdin, nullptr, _IOFBF, StdinBufferSize);
+            this->input.rdbuf(std::cin.rdbuf());
+            this->readFromStdin = true;
+            return true;
+        }
+
+        this->file.open(fileName, std::ios::binary);
+        if (!this->file.is_open())
+            return false;
+        this->input.rdbuf(this->file.rdbuf());
+        return true;
+    }
+
+    // If the input is memory mapped, frames point directly into the mapping
+    std::unique_ptr<MappedFile> mappedFile;
+    size_t mappedPosition{};
+    bool mappedEof{};
+
+    void openMapping(const std::string &fileName)
+    {
+        this->mappedFile = std::make_unique<MappedFile>(fileName);
+        if (!this->mappedFile->isOpen())
+        {
+            vca_log(LogLevel::Info, "Memory mapping not possible. Reading the file instead.");
+            this->mappedFile.reset();
+        }
+    }
+
+    // Let the frame point to the data at the given position in the mapping. High bit depth
+    // data that is not aligned to 16 bit is copied instead.
+    bool setFrameFromMapping(FrameWithData &frame, size_t position)
+    {
+        if (position + frame.getFrameSize() > this->mappedFile->getSize())
+        {
+            this->mappedEof = true;
+            return false;
+        }
+
+        auto frameData = this->mappedFile->getData() + position;
+        if (this->frameInfo.bitDepth > 8 && position % 2 != 0)
+        {
+            frame.setExternalData(nullptr);
+            std::copy(frameData, frameData + frame.getFrameSize(), frame.getData());
+        }
+        else
+            frame.setExternalData(frameData);
+
+        this->mappedPosition = position + frame.getFrameSize();
+        return true;
+    }
 
 public:
     virtual ~IInputFile() {}
 
+    // Reading from a pipe is done in large blocks so that the decoder writing to it does not stall
+    static constexpr size_t StdinBufferSize = 4 * 1024 * 1024;
+
     virtual bool readFrame(FrameWithData &frame) = 0;
+    // Continue reading at the given frame. Not possible when reading from stdin.
+    virtual bool seekToFrame(unsigned frameIndex) = 0;
 
     static size_t calculateFrameBytesInInput(const vca_frame_info &frameInfo)
     {
@@ -61,6 +139,8 @@ public:
 
     bool isEof() const
     {
+        if (this->mappedFile)
+            return this->mappedEof;
         return this->input.eof();
     }
     bool isFail()
@@ -68,10 +148,22 @@ public:
         return this->input.fail();
     }
 
+    // The frame was analyzed and its data will not be used again
+    void releaseFrame(const FrameWithData &frame)
+    {
+        if (this->mappedFile)
+            this->mappedFile->release(frame.getData(), frame.getFrameSize());
+    }
+
     vca_frame_info getFrameInfo() const
     {
         return this->frameInfo;
     }
+    // The number of frames in the input. Only estimated for Y4M and 0 if unknown.
+    unsigned getFrameCount() const
+    {
+        return this->frameCount;
+    }
     virtual double getFPS() const = 0;
 };
 
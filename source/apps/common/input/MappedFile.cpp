@@ -0,0 +1,94 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "MappedFile.h"
+
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vca {
+
+#ifndef _WIN32
+
+MappedFile::MappedFile(const std::string &fileName)
+{
+    this->fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (this->fileDescriptor < 0)
+        return;
+
+    struct stat fileStat;
+    if (fstat(this->fileDescriptor, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)
+        || fileStat.st_size == 0)
+        return;
+
+    auto mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, this->fileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+        return;
+
+    this->data = (uint8_t *) (mapping);
+    this->size = size_t(fileStat.st_size);
+    madvise(mapping, this->size, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile()
+{
+    if (this->data)
+        munmap(this->data, this->size);
+    if (this->fileDescriptor >= 0)
+        close(this->fileDescriptor);
+}
+
+void MappedFile::release(const uint8_t *rangeStart, size_t rangeSize)
+{
+    if (rangeStart < this->data || rangeStart + rangeSize > this->data + this->size)
+        return;
+
+    // Only release whole pages. The page at the end may still hold data of the next range.
+    // Data before the first released range is not touched. It may be used by someone else.
+    static const auto pageSize = size_t(sysconf(_SC_PAGESIZE));
+    auto start                 = size_t(rangeStart - this->data);
+    auto releaseStart          = std::max(this->releasedUntil, start / pageSize * pageSize);
+    auto releaseEnd            = (start + rangeSize) / pageSize * pageSize;
+    if (releaseEnd <= releaseStart)
+        return;
+
+    auto length = releaseEnd - releaseStart;
+    madvise(this->data + releaseStart, length, MADV_DONTNEED);
+    posix_fadvise(this->fileDescriptor, off_t(releaseStart), off_t(length), POSIX_FADV_DONTNEED);
+    this->releasedUntil = releaseEnd;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &)
+{}
+
+MappedFile::~MappedFile() {}
+
+void MappedFile::release(const uint8_t *, size_t) {}
+
+#endif
+
+} // namespace vca
@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vca {
+
+// A read only memory mapping of a whole file. The file is read sequentially, so the OS is asked
+// to read ahead and the pages that were already used can be released again.
+// Memory mapping is not supported on Windows. There isOpen() will always return false.
+class MappedFile
+{
+public:
+    MappedFile(const std::string &fileName);
+    ~MappedFile();
+
+    bool isOpen() const
+    {
+        return this->data != nullptr;
+    }
+    const uint8_t *getData() const
+    {
+        return this->data;
+    }
+    size_t getSize() const
+    {
+        return this->size;
+    }
+
+    // Release the pages up to the end of the given range. They will not be read again.
+    // Ranges must be released in the order of the file.
+    void release(const uint8_t *rangeStart, size_t rangeSize);
+
+private:
+    int fileDescriptor{-1};
+    uint8_t *data{};
+    size_t size{};
+    size_t releasedUntil{};
+};
+
+} // namespace vca
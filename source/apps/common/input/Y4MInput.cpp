@@ -28,15 +28,18 @@ namespace filesystem = std::experimental::filesystem;
 namespace filesystem = std::filesystem;
 #endif
 
+#include <cctype>
+#include <cstring>
 #include <iterator>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace vca {
 
-Y4MInput::Y4MInput(std::string &fileName, unsigned skipFrames)
+Y4MInput::Y4MInput(std::string &fileName, unsigned skipFrames, bool useMapping)
 {
-    input.open(fileName, std::ios::binary);
-    if (!input.good())
+    if (!this->openInput(fileName))
     {
         vca_log(LogLevel::Error, "Error opening file");
         return;
@@ -48,45 +51,73 @@ Y4MInput::Y4MInput(std::string &fileName, unsigned skipFrames)
         return;
     }
 
+    if (this->readFromStdin)
+        vca_log(LogLevel::Info, "Reading from stdin. The number of frames is unknown.");
+    else
     {
         const auto assumedHeaderSize = 6u;
         auto estFrameSize            = IInputFile::calculateFrameBytesInInput(this->frameInfo)
                             + assumedHeaderSize;
-        auto fileSize    = filesystem::file_size(fileName);
-        this->frameCount = unsigned(fileSize / estFrameSize);
+        this->fileSize   = size_t(filesystem::file_size(fileName));
+        this->frameCount = unsigned(this->fileSize / estFrameSize);
         vca_log(LogLevel::Info, "Detected " + std::to_string(this->frameCount) + " frames in input");
+
+        // The first frame starts right after the header
+        this->frameOffsets.push_back(size_t(this->input.tellg()));
+    }
+
+    if (useMapping && !this->readFromStdin)
+    {
+        this->openMapping(fileName);
+        if (this->mappedFile)
+            this->mappedPosition = this->frameOffsets.front();
     }
 
-    if (skipFrames)
-    {}
+    if (skipFrames && this->readFromStdin)
+    {
+        vca_log(LogLevel::Info, "Skipping " + std::to_string(skipFrames) + " frames from stdin");
+        const auto frameSizeBytes = IInputFile::calculateFrameBytesInInput(this->frameInfo);
+        for (unsigned i = 0; i < skipFrames && this->readFrameTag(); i++)
+            this->input.ignore(std::streamsize(frameSizeBytes));
+    }
+    else if (skipFrames)
+    {
+        vca_log(LogLevel::Info, "Seeking to frame " + std::to_string(skipFrames));
+        if (!this->seekToFrame(skipFrames))
+            vca_log(LogLevel::Warning, "The input has fewer frames than should be skipped");
+    }
 }
 
 bool Y4MInput::parseHeader()
 {
-    auto it = std::istreambuf_iterator<char>(this->input);
-
-    auto getNextHeaderField = [&it]() {
-        if (*it == '\n')
-            return std::string();
-        if (*it == ' ')
-            it++;
-        std::string str;
-        while (it != std::istreambuf_iterator<char>() && *it != ' ' && *it != '\n')
-            str.push_back(*it++);
-        return str;
-    };
-
-    if (getNextHeaderField() != "YUV4MPEG2")
+    std::string header;
+    if (!std::getline(this->input, header))
+    {
+        vca_log(LogLevel::Error, "Error reading Y4M header");
+        return false;
+    }
+
+    std::vector<std::string> fields;
+    size_t fieldStart = 0;
+    while (fieldStart < header.size())
+    {
+        auto fieldEnd = header.find(' ', fieldStart);
+        if (fieldEnd == std::string::npos)
+            fieldEnd = header.size();
+        if (fieldEnd > fieldStart)
+            fields.push_back(header.substr(fieldStart, fieldEnd - fieldStart));
+        fieldStart = fieldEnd + 1;
+    }
+
+    if (fields.empty() || fields[0] != "YUV4MPEG2")
     {
         vca_log(LogLevel::Error, "Y4M file must start with YUV4MPEG2");
         return false;
     }
 
-    while (true)
+    for (size_t i = 1; i < fields.size(); i++)
     {
-        auto field = getNextHeaderField();
-        if (field.empty())
-            break;
+        const auto &field = fields[i];
 
         auto parameterIndicator = field[0];
         if (parameterIndicator == 'W')
@@ -132,6 +163,14 @@ bool Y4MInput::parseHeader()
             else
                 vca_log(LogLevel::Info,
                         "Y4M invalid colorspace indicator (" + indicator + "). Assuming 4:2:0.");
+
+            // High bit depth files signal the depth after the subsampling (e.g. C420p10)
+            if (field.size() > 5 && field[4] == 'p' && std::isdigit(field[5]))
+            {
+                this->frameInfo.bitDepth = unsigned(std::stoul(field.substr(5)));
+                vca_log(LogLevel::Info,
+                        "Y4M Detected bit depth " + std::to_string(this->frameInfo.bitDepth));
+            }
         }
         else if (parameterIndicator == 'F')
         {
@@ -161,32 +200,104 @@ bool Y4MInput::parseHeader()
     return true;
 }
 
-bool Y4MInput::readFrame(FrameWithData &frame)
+size_t Y4MInput::parseFrameTag(const uint8_t *data, size_t size)
 {
-    char c = 0;
-    while (this->input.get(c) && c != 'F')
-    {}
+    if (size == 0)
+        return 0;
+    if (size < 5 || std::memcmp(data, "FRAME", 5) != 0)
+        throw std::runtime_error("Error reading FRAME tag");
 
-    if (this->input.eof())
-        return false;
+    auto lineEnd = (const uint8_t *) (std::memchr(data, '\n', size));
+    if (lineEnd == nullptr)
+        return 0;
+    return size_t(lineEnd + 1 - data);
+}
 
-    if (!this->input.good())
-        throw std::runtime_error("Error reading from file");
+bool Y4MInput::readFrameTag()
+{
+    std::string tag;
+    if (!std::getline(this->input, tag))
+        return false;
+    if (tag.compare(0, 5, "FRAME") != 0)
+        throw std::runtime_error("Error reading FRAME tag");
+    return true;
+}
 
-    auto getNextChar = [this]() {
-        char c;
-        if (!this->input.get(c))
-            return char(0);
-        return c;
-    };
+size_t Y4MInput::getFrameTagLength(size_t position)
+{
+    if (this->mappedFile)
+        return parseFrameTag(this->mappedFile->getData() + position,
+                             this->mappedFile->getSize() - position);
 
-    if (getNextChar() != 'R' || getNextChar() != 'A' || getNextChar() != 'M' || getNextChar() != 'E')
+    this->input.clear();
+    this->input.seekg(std::streampos(position));
+    std::string tag;
+    if (!std::getline(this->input, tag) || this->input.eof())
+        return 0;
+    if (tag.compare(0, 5, "FRAME") != 0)
         throw std::runtime_error("Error reading FRAME tag");
+    return tag.size() + 1;
+}
+
+bool Y4MInput::seekToFrame(unsigned frameIndex)
+{
+    if (this->readFromStdin)
+        return false;
+
+    // All frames have the same size but the FRAME tags may carry parameters. Only the tags
+    // are read to find the start of the next frame.
+    const auto frameSizeBytes = IInputFile::calculateFrameBytesInInput(this->frameInfo);
+    while (this->frameOffsets.size() <= frameIndex)
+    {
+        const auto position  = this->frameOffsets.back();
+        const auto tagLength = position < this->fileSize ? this->getFrameTagLength(position) : 0;
+        if (tagLength == 0)
+        {
+            // The input ends before the frame
+            this->mappedEof = true;
+            this->input.setstate(std::ios::eofbit);
+            return false;
+        }
+        this->frameOffsets.push_back(position + tagLength + frameSizeBytes);
+    }
+
+    const auto position = this->frameOffsets[frameIndex];
+    if (this->mappedFile)
+    {
+        this->mappedPosition = position;
+        this->mappedEof      = false;
+    }
+    else
+    {
+        this->input.clear();
+        this->input.seekg(std::streampos(position));
+    }
+    return position < this->fileSize;
+}
+
+bool Y4MInput::readFrameFromMapping(FrameWithData &frame)
+{
+    auto tagLength = parseFrameTag(this->mappedFile->getData() + this->mappedPosition,
+                                   this->mappedFile->getSize() - this->mappedPosition);
+    if (tagLength == 0)
+    {
+        this->mappedEof = true;
+        return false;
+    }
 
-    while (this->input.get(c) && c != '\n')
-    {}
+    return this->setFrameFromMapping(frame, this->mappedPosition + tagLength);
+}
+
+bool Y4MInput::readFrame(FrameWithData &frame)
+{
+    if (this->mappedFile)
+        return this->readFrameFromMapping(frame);
 
-    this->input.read((char *) (frame.getData()), frame.getFrameSize());
+    if (!this->readFrameTag())
+        return false;
+
+    if (!this->input.read((char *) (frame.getData()), frame.getFrameSize()))
+        return false;
 
     return true;
 }
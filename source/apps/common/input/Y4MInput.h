@@ -21,6 +21,7 @@
 
 #include "IInputFile.h"
 #include <fstream>
+#include <vector>
 
 namespace vca {
 
@@ -28,15 +29,28 @@ class Y4MInput : public IInputFile
 {
 protected:
     bool parseHeader();
+    bool readFrameFromMapping(FrameWithData &frame);
+
+    // Get the length of the FRAME tag line (including the newline) at the start of the data.
+    // Returns 0 if there is no complete tag.
+    static size_t parseFrameTag(const uint8_t *data, size_t size);
+    // Read the FRAME tag line from the input. Returns false at the end of the input.
+    bool readFrameTag();
+    size_t getFrameTagLength(size_t position);
 
     double fps{};
+    size_t fileSize{};
+
+    // The file offsets of the FRAME tags of all frames that were seeked over so far
+    std::vector<size_t> frameOffsets;
 
 public:
     Y4MInput() = delete;
-    Y4MInput(std::string &fileName, unsigned skipFrames);
+    Y4MInput(std::string &fileName, unsigned skipFrames, bool useMapping);
     ~Y4MInput() = default;
 
     bool readFrame(FrameWithData &frame) override;
+    bool seekToFrame(unsigned frameIndex) override;
     double getFPS() const override;
 };
 
@@ -32,7 +32,10 @@ namespace filesystem = std::filesystem;
 
 namespace vca {
 
-YUVInput::YUVInput(std::string &fileName, vca_frame_info &openFrameInfo, unsigned skipFrames)
+YUVInput::YUVInput(std::string &fileName,
+                   vca_frame_info &openFrameInfo,
+                   unsigned skipFrames,
+                   bool useMapping)
 {
     frameInfo = openFrameInfo;
 
@@ -43,8 +46,7 @@ YUVInput::YUVInput(std::string &fileName, vca_frame_info &openFrameInfo, unsigne
         return;
     }
 
-    input.open(fileName, std::ios::binary);
-    if (!input.good())
+    if (!this->openInput(fileName))
     {
         vca_log(LogLevel::Error, "Error opening file");
         return;
@@ -52,22 +54,55 @@ YUVInput::YUVInput(std::string &fileName, vca_frame_info &openFrameInfo, unsigne
 
     auto frameSizeBytes = IInputFile::calculateFrameBytesInInput(this->frameInfo);
 
+    if (this->readFromStdin)
+        vca_log(LogLevel::Info, "Reading from stdin. The number of frames is unknown.");
+    else
     {
         auto fileSize    = filesystem::file_size(fileName);
         this->frameCount = unsigned(fileSize / frameSizeBytes);
         vca_log(LogLevel::Info, "Detected " + std::to_string(this->frameCount) + " frames in input");
     }
 
-    if (skipFrames)
+    if (useMapping && !this->readFromStdin)
+        this->openMapping(fileName);
+
+    if (skipFrames && this->readFromStdin)
+    {
+        vca_log(LogLevel::Info, "Skipping " + std::to_string(skipFrames) + " frames from stdin");
+        input.ignore(std::streamsize(frameSizeBytes * skipFrames));
+    }
+    else if (skipFrames)
     {
-        auto filePos = std::streampos(frameSizeBytes * skipFrames);
-        vca_log(LogLevel::Info, "Seeking file to pos " + std::to_string(filePos));
-        input.seekg(filePos);
+        vca_log(LogLevel::Info,
+                "Seeking file to pos " + std::to_string(frameSizeBytes * skipFrames));
+        this->seekToFrame(skipFrames);
     }
 }
 
+bool YUVInput::seekToFrame(unsigned frameIndex)
+{
+    if (this->readFromStdin)
+        return false;
+
+    auto position = IInputFile::calculateFrameBytesInInput(this->frameInfo) * frameIndex;
+    if (this->mappedFile)
+    {
+        this->mappedPosition = position;
+        this->mappedEof      = false;
+    }
+    else
+    {
+        this->input.clear();
+        this->input.seekg(std::streampos(position));
+    }
+    return frameIndex < this->frameCount;
+}
+
 bool YUVInput::readFrame(FrameWithData &frame)
 {
+    if (this->mappedFile)
+        return this->setFrameFromMapping(frame, this->mappedPosition);
+
     if (!this->input.good() || this->input.eof())
         return false;
 
@@ -29,10 +29,14 @@ class YUVInput : public IInputFile
 {
 public:
     YUVInput() = delete;
-    YUVInput(std::string &fileName, vca_frame_info &openFrameInfo, unsigned skipFrames);
+    YUVInput(std::string &fileName,
+             vca_frame_info &openFrameInfo,
+             unsigned skipFrames,
+             bool useMapping);
     ~YUVInput() = default;
 
     bool readFrame(FrameWithData &frame) override;
+    bool seekToFrame(unsigned frameIndex) override;
     double getFPS() const override;
 };
 
@@ -26,12 +26,15 @@ using namespace std::string_literals;
 
 YUViewStatsFile::YUViewStatsFile(const std::string &filename,
                                  const std::string &inputFilename,
-                                 const vca_frame_info &info)
+                                 const vca_frame_info &info,
+                                 bool writeHeader)
 {
     this->info = info;
     this->file.open(filename);
 
     vca_log(LogLevel::Info, "Opened YUView csv file " + filename);
+    if (!writeHeader)
+        return;
 
     this->file << "%;syntax-version;v1.22\n"s;
     this->file << "%;%;Written by VCA for YUView\n"s;
@@ -46,7 +49,7 @@ YUViewStatsFile::YUViewStatsFile(const std::string &filename,
     this->file << "%;defaultRange;0;3000;heat\n"s;
 }
 
-void YUViewStatsFile::write(const vca_frame_results &results, unsigned blockSize)
+void YUViewStatsFile::write(const vca_borrowed_frame_results &results, unsigned blockSize)
 {
     auto widthInBlocks = (info.width + blockSize - 1) / blockSize;
     auto heightInBlock = (info.height + blockSize - 1) / blockSize;
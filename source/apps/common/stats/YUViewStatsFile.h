@@ -29,12 +29,14 @@ namespace vca {
 class YUViewStatsFile
 {
 public:
+    // Without the header, the file can only be appended to another stats file
     YUViewStatsFile(const std::string &filename,
                     const std::string &inputFilename,
-                    const vca_frame_info &info);
+                    const vca_frame_info &info,
+                    bool writeHeader);
     ~YUViewStatsFile() = default;
 
-    void write(const vca_frame_results &results, unsigned blockSize);
+    void write(const vca_borrowed_frame_results &results, unsigned blockSize);
 
 private:
     std::ofstream file;
@@ -20,17 +20,23 @@
 
 #include "vcacli.h"
 
+#include <common/PipelineQueue.h>
 #include <common/input/Y4MInput.h>
 #include <common/input/YUVInput.h>
 #include <common/stats/YUViewStatsFile.h>
 #include <lib/vcaLib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <signal.h>
 #include <queue>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -54,6 +60,9 @@ void logLibraryMessage(void *, LogLevel logLevel, const char *message)
 
 void printStatus(uint32_t frameNum, unsigned framesToBeAnalyzed, bool printSummary = false)
 {
+    static std::mutex statusMutex;
+    std::unique_lock<std::mutex> lock(statusMutex);
+
     char buf[200];
     static auto startTime      = std::chrono::high_resolution_clock::now();
     static auto prevUpdateTime = std::chrono::high_resolution_clock::now();
@@ -108,6 +117,9 @@ struct CLIOptions
     std::string inputFilename;
     bool openAsY4m{};
     unsigned skipFrames{};
+    bool useMapping{true};
+    unsigned readAhead{8};
+    unsigned nrRanges{1};
     unsigned framesToBeAnalyzed{};
     std::string complexityCSVFilename;
     std::string shotCSVFilename;
@@ -117,22 +129,46 @@ struct CLIOptions
     vca_shot_detection_param shotDetectParam;
 };
 
-struct Result
+using framePtr = std::unique_ptr<FrameWithData>;
+
+// A frame whose result was pulled from the analyzer but not written yet
+struct AnalyzedFrame
 {
-    Result(const vca_frame_info &info, unsigned blockSize)
-    {
-        auto widthInBlocks = (info.width + blockSize - 1) / blockSize;
-        auto heightInBlock = (info.height + blockSize - 1) / blockSize;
-        auto numberBlocks  = widthInBlocks * heightInBlock;
-        this->energyPerBlockData.resize(numberBlocks);
-        this->result.energyPerBlock = this->energyPerBlockData.data();
-        this->sadPerBlockData.resize(numberBlocks);
-        this->result.sadPerBlock = this->sadPerBlockData.data();
-    }
+    const vca_borrowed_frame_results *result{};
+    framePtr frame;
+};
+
+// A range of frames of the input that is analyzed by an own analyzer
+struct FrameRange
+{
+    unsigned start{};
+    // 0 means until the end of the input
+    unsigned count{};
+    // The SAD and epsilon of a frame depend on the two frames before it. These frames are
+    // analyzed before the start, so that the results match the results of a sequential run.
+    unsigned leadingFrames{};
+};
+
+// The shot detection runs while the frames are analyzed. The shots are written as soon as they
+// are decided.
+struct ShotsFile
+{
+    std::ofstream file;
+    vca_shot_detector *detector{};
+    size_t frameCounter{};
+    size_t shotCounter{};
+};
 
-    std::vector<uint32_t> energyPerBlockData;
-    std::vector<uint32_t> sadPerBlockData;
-    vca_frame_results result;
+struct RangeOutput
+{
+    bool writeHeaders{};
+    std::ofstream complexityFile;
+    std::string yuviewStatsFilename;
+    std::unique_ptr<YUViewStatsFile> yuviewStatsFile;
+    // Only the first range pushes to the shot detection directly. The other ranges keep their
+    // epsilon values until all frames before them were pushed.
+    ShotsFile *shotsFile{};
+    std::vector<double> epsilonValues;
 };
 
 std::optional<CLIOptions> parseCLIOptions(int argc, char **argv)
@@ -187,13 +223,15 @@ std::optional<CLIOptions> parseCLIOptions(int argc, char **argv)
         }
 
         auto name = std::string(long_options[long_options_index].name);
-        auto arg  = std::string(optarg);
+        auto arg  = std::string(optarg ? optarg : "");
         if (name == "asm")
             options.vcaParam.enableASM = true;
         else if (name == "no-asm")
             options.vcaParam.enableASM = false;
         else if (name == "input")
             options.inputFilename = optarg;
+        else if (name == "y4m")
+            options.openAsY4m = true;
         else if (name == "input-depth")
             options.vcaParam.frameInfo.bitDepth = std::stoul(optarg);
         else if (name == "input-res")
@@ -222,6 +260,14 @@ std::optional<CLIOptions> parseCLIOptions(int argc, char **argv)
             options.shotDetectParam.fps = std::stod(optarg);
         else if (name == "skip")
             options.skipFrames = std::stoul(optarg);
+        else if (name == "no-mmap")
+            options.useMapping = false;
+        else if (name == "read-ahead")
+            options.readAhead = std::stoul(optarg);
+        else if (name == "ranges")
+            options.nrRanges = std::stoul(optarg);
+        else if (name == "stats")
+            options.vcaParam.enableStats = true;
         else if (name == "frames")
             options.framesToBeAnalyzed = std::stoul(optarg);
         else if (name == "complexity-csv")
@@ -238,9 +284,12 @@ std::optional<CLIOptions> parseCLIOptions(int argc, char **argv)
             options.vcaParam.blockSize = std::stoi(optarg);
         else if (name == "threads")
             options.vcaParam.nrFrameThreads = std::stoi(optarg);
+        else if (name == "slice-threads")
+            options.vcaParam.nrSliceThreads = std::stoi(optarg);
     }
 
-    if (options.inputFilename.substr(options.inputFilename.size() - 4) == ".y4m")
+    if (options.inputFilename.size() >= 4
+        && options.inputFilename.substr(options.inputFilename.size() - 4) == ".y4m")
         options.openAsY4m = true;
 
     return options;
@@ -254,9 +303,9 @@ bool checkOptions(CLIOptions options)
         return false;
     }
 
-    if (options.vcaParam.frameInfo.bitDepth < 8 || options.vcaParam.frameInfo.bitDepth > 16)
+    if (options.vcaParam.frameInfo.bitDepth < 8 || options.vcaParam.frameInfo.bitDepth > 12)
     {
-        vca_log(LogLevel::Error, "Bit depth must be between 8 and 16 bits.");
+        vca_log(LogLevel::Error, "Bit depth must be between 8 and 12 bits.");
         return false;
     }
 
@@ -276,6 +325,12 @@ bool checkOptions(CLIOptions options)
         return false;
     }
 
+    if (options.readAhead == 0)
+    {
+        vca_log(LogLevel::Error, "The read ahead must be at least 1 frame.");
+        return false;
+    }
+
     return true;
 }
 
@@ -286,48 +341,52 @@ void logOptions(const CLIOptions &options)
     vca_log(LogLevel::Info, "  Open as Y4m:       "s + (options.openAsY4m ? "True"s : "False"s));
     vca_log(LogLevel::Info, "  Skip frames:       "s + std::to_string(options.skipFrames));
     vca_log(LogLevel::Info, "  Frames to analyze: "s + std::to_string(options.framesToBeAnalyzed));
+    vca_log(LogLevel::Info, "  Read ahead:        "s + std::to_string(options.readAhead));
+    vca_log(LogLevel::Info, "  Ranges:            "s + std::to_string(options.nrRanges));
     vca_log(LogLevel::Info, "  Complexity csv:    "s + options.complexityCSVFilename);
     vca_log(LogLevel::Info, "  Shot csv:          "s + options.shotCSVFilename);
     vca_log(LogLevel::Info, "  YUView stats file: "s + options.yuviewStatsFilename);
+    vca_log(LogLevel::Info,
+            "  Timing stats:      "s + (options.vcaParam.enableStats ? "True"s : "False"s));
 }
 
-void logResult(const Result &result, const vca_frame *frame, const unsigned resultsCounter)
+void logResult(const vca_borrowed_frame_results &result,
+               const vca_frame *frame,
+               const unsigned resultsCounter)
 {
-    if (result.result.poc != frame->stats.poc)
+    if (result.poc != frame->stats.poc)
         vca_log(LogLevel::Warning,
-                "The poc of the returned data (" + std::to_string(result.result.poc)
+                "The poc of the returned data (" + std::to_string(result.poc)
                     + ") does not match the expected next frames POC ("
                     + std::to_string(frame->stats.poc) + ").");
-    if (result.result.poc != resultsCounter)
+    if (result.poc != resultsCounter)
         vca_log(LogLevel::Warning,
-                "The poc of the returned data (" + std::to_string(result.result.poc)
+                "The poc of the returned data (" + std::to_string(result.poc)
                     + ") does not match the expected results counter ("
                     + std::to_string(resultsCounter) + ").");
 
     vca_log(LogLevel::Debug,
-            "Got results POC " + std::to_string(result.result.poc) + " averageEnergy "
-                + std::to_string(result.result.averageEnergy) + " sad "
-                + std::to_string(result.result.sad));
+            "Got results POC " + std::to_string(result.poc) + " averageEnergy "
+                + std::to_string(result.averageEnergy) + " sad " + std::to_string(result.sad));
 }
 
-void writeComplexityStatsToFile(const Result &result, std::ofstream &file)
+void writeComplexityStatsToFile(const vca_borrowed_frame_results &result, std::ofstream &file)
 {
-    file << result.result.poc << ", " << result.result.averageEnergy << ", " << result.result.sad
-         << ", " << result.result.epsilon << "\n";
+    file << result.poc << ", " << result.averageEnergy << ", " << result.sad << ", "
+         << result.epsilon << "\n";
 }
 
-void writeShotDetectionResultsToFile(const std::vector<vca_shot_detect_frame> &shotDetectFrames,
-                                     std::ofstream &file)
+void writeDecidedShotsToFile(ShotsFile &shotsFile)
 {
-    size_t shotCounter = 0;
-    for (size_t i = 0; i < shotDetectFrames.size(); i++)
+    vca_shot_detect_frame frame;
+    while (vca_shot_detector_pop(shotsFile.detector, &frame))
     {
-        auto &frame = shotDetectFrames.at(i);
         if (frame.isNewShot)
         {
-            file << shotCounter << ", " << i << "\n";
-            shotCounter++;
+            shotsFile.file << shotsFile.shotCounter << ", " << shotsFile.frameCounter << "\n";
+            shotsFile.shotCounter++;
         }
+        shotsFile.frameCounter++;
     }
 }
 
@@ -371,99 +430,148 @@ static int get_argv_utf8(int *argc_ptr, char ***argv_ptr)
 }
 #endif
 
-int main(int argc, char **argv)
+std::unique_ptr<IInputFile> openInputFile(CLIOptions &options, unsigned skipFrames)
 {
-#if _WIN32
-    char **orgArgv = argv;
-    get_argv_utf8(&argc, &argv);
-#endif
+    if (options.openAsY4m)
+        return std::make_unique<Y4MInput>(options.inputFilename, skipFrames, options.useMapping);
+    return std::make_unique<YUVInput>(options.inputFilename,
+                                      options.vcaParam.frameInfo,
+                                      skipFrames,
+                                      options.useMapping);
+}
 
-    vca_log(LogLevel::Info, "VCA - Video Complexity Analyzer " + std::string(vca_version_str));
+std::vector<FrameRange> splitIntoRanges(const CLIOptions &options, unsigned framesInInput)
+{
+    auto nrFrames = framesInInput;
+    if (options.framesToBeAnalyzed > 0)
+        nrFrames = std::min(nrFrames, options.framesToBeAnalyzed);
 
-    CLIOptions options;
-    if (auto cliOptions = parseCLIOptions(argc, argv))
-        options = *cliOptions;
-    else
-    {
-        vca_log(LogLevel::Error, "Error parsing parameters");
-        return 1;
-    }
+    auto nrRanges = std::min(options.nrRanges, nrFrames);
+    if (nrRanges <= 1)
+        return {FrameRange{0, options.framesToBeAnalyzed, 0}};
 
-    if (!checkOptions(options))
+    std::vector<FrameRange> ranges;
+    for (unsigned i = 0; i < nrRanges; i++)
     {
-        vca_log(LogLevel::Error, "Error checking parameters");
-        return 1;
+        FrameRange range;
+        range.start         = nrFrames * i / nrRanges;
+        range.count         = nrFrames * (i + 1) / nrRanges - range.start;
+        range.leadingFrames = std::min(range.start, 2u);
+        ranges.push_back(range);
     }
 
-    logOptions(options);
+    // The number of frames in a Y4M file is only estimated
+    if (options.framesToBeAnalyzed == 0)
+        ranges.back().count = 0;
 
-    std::unique_ptr<IInputFile> inputFile;
-    if (options.openAsY4m)
-        inputFile = std::make_unique<Y4MInput>(options.inputFilename, options.skipFrames);
-    else
-        inputFile = std::make_unique<YUVInput>(options.inputFilename,
-                                               options.vcaParam.frameInfo,
-                                               options.skipFrames);
+    return ranges;
+}
 
-    if (inputFile->isFail())
+std::string getRangeFilename(const std::string &filename, size_t rangeIndex)
+{
+    return filename + ".range" + std::to_string(rangeIndex);
+}
+
+void appendRangeFile(const std::string &filename, size_t rangeIndex)
+{
+    auto rangeFilename = getRangeFilename(filename, rangeIndex);
     {
-        vca_log(LogLevel::Error, "Error opening input file");
-        return 1;
+        std::ifstream rangeFile(rangeFilename, std::ios::binary);
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        if (rangeFile.peek() != std::ifstream::traits_type::eof())
+            file << rangeFile.rdbuf();
     }
+    std::remove(rangeFilename.c_str());
+}
 
-    std::ofstream complexityFile;
-    if (!options.complexityCSVFilename.empty())
+// Close the outputs of the ranges after the first one and delete their files. Used if the
+// analysis fails so that no range files are left next to the output files.
+void removeRangeFiles(const CLIOptions &options, std::vector<RangeOutput> &outputs)
+{
+    for (size_t i = 1; i < outputs.size(); i++)
     {
-        complexityFile.open(options.complexityCSVFilename);
-        if (!complexityFile.is_open())
-        {
-            vca_log(LogLevel::Error,
-                    "Error opening complexity CSV file " + options.complexityCSVFilename);
-            return 1;
-        }
-        complexityFile << "POC, E, h, epsilon \n";
+        outputs[i].complexityFile.close();
+        outputs[i].yuviewStatsFile.reset();
+        if (!options.complexityCSVFilename.empty())
+            std::remove(getRangeFilename(options.complexityCSVFilename, i).c_str());
+        if (!options.yuviewStatsFilename.empty())
+            std::remove(getRangeFilename(options.yuviewStatsFilename, i).c_str());
     }
+}
 
-    options.vcaParam.logFunction        = logLibraryMessage;
-    options.shotDetectParam.logFunction = logLibraryMessage;
+void logAnalyzerStats(vca_analyzer *analyzer, const FrameRange &range)
+{
+    vca_analyzer_stats stats;
+    if (vca_analyzer_get_stats(analyzer, &stats) == VCA_ERROR)
+        return;
+
+    auto toMs = [](uint64_t ns) { return std::to_string(ns / 1000000) + " ms"; };
+
+    vca_log(LogLevel::Info, "Stats of range starting at frame " + std::to_string(range.start));
+    vca_log(LogLevel::Info,
+            "  Frames: " + std::to_string(stats.frames) + " Jobs: " + std::to_string(stats.jobs));
+    vca_log(LogLevel::Info,
+            "  Padding copy: " + toMs(stats.copyNs) + " Transform: " + toMs(stats.transformNs)
+                + " Weighted sum: " + toMs(stats.weightedSumNs)
+                + " SAD/epsilon: " + toMs(stats.sadNs));
+    vca_log(LogLevel::Info,
+            "  Push wait: " + toMs(stats.pushWaitNs) + " Pull wait: " + toMs(stats.pullWaitNs)
+                + " Pull copy: " + toMs(stats.pullCopyNs));
+    vca_log(LogLevel::Info,
+            "  Job queue depth: average " + std::to_string(stats.averageJobQueueDepth) + " max "
+                + std::to_string(stats.maxJobQueueDepth));
+
+    for (unsigned i = 0; i < stats.nrThreads; i++)
+    {
+        vca_thread_stats threadStats;
+        if (vca_analyzer_get_thread_stats(analyzer, i, &threadStats) == VCA_ERROR)
+            continue;
+        vca_log(LogLevel::Info,
+                "  Thread " + std::to_string(i) + ": Busy " + toMs(threadStats.busyNs) + " Idle "
+                    + toMs(threadStats.idleNs) + " Jobs " + std::to_string(threadStats.jobs));
+    }
+}
 
-    auto analyzer = vca_analyzer_open(options.vcaParam);
+// Analyze the frames of one range with an own analyzer.
+// The frames are read in a reader thread ahead of the analysis and the results are written
+// in a writer thread. The calling thread only pushes the frames to the analyzer and pulls the
+// results. Returns the exit code.
+int analyzeRange(const CLIOptions &options,
+                 const vca_param &vcaParam,
+                 const FrameRange &range,
+                 IInputFile &inputFile,
+                 RangeOutput &output,
+                 std::atomic<unsigned> &writtenFrames)
+{
+    auto analyzer = vca_analyzer_open(vcaParam);
     if (analyzer == nullptr)
     {
         vca_log(LogLevel::Error, "Error opening analyzer");
         return 2;
     }
 
-    /* Control-C handler */
-    if (signal(SIGINT, sigint_handler) == SIG_ERR)
-        vca_log(LogLevel::Error,
-                "Unable to register CTRL+C handler: " + std::string(strerror(errno)));
+    const auto firstPoc       = range.start - range.leadingFrames;
+    const auto framesToBeRead = range.count == 0 ? 0 : range.count + range.leadingFrames;
 
-    auto frameInfo = inputFile->getFrameInfo();
+    PipelineQueue<framePtr> frameRecycling(0);
+    PipelineQueue<framePtr> readFrames(options.readAhead);
+    PipelineQueue<AnalyzedFrame> analyzedFrames(options.readAhead);
 
-    using framePtr = std::unique_ptr<FrameWithData>;
-    std::queue<framePtr> frameRecycling;
-    std::queue<framePtr> activeFrames;
-    std::unique_ptr<YUViewStatsFile> yuviewStatsFile;
-    std::vector<vca_shot_detect_frame> shotDetectFrames;
-    unsigned pushedFrames   = 0;
-    unsigned resultsCounter = 0;
-    while (!inputFile->isEof() && !inputFile->isFail()
-           && (options.framesToBeAnalyzed == 0 || pushedFrames < options.framesToBeAnalyzed))
-    {
+    std::atomic<bool> readError{};
+    auto readerStage = [&]() {
+        unsigned readCounter = 0;
+        while (!inputFile.isEof() && !inputFile.isFail()
+               && (framesToBeRead == 0 || readCounter < framesToBeRead))
         {
             framePtr frame;
-            if (frameRecycling.empty())
-                frame = std::make_unique<FrameWithData>(inputFile->getFrameInfo());
+            if (auto recycledFrame = frameRecycling.tryPop())
+                frame = std::move(*recycledFrame);
             else
-            {
-                frame = std::move(frameRecycling.front());
-                frameRecycling.pop();
-            }
+                frame = std::make_unique<FrameWithData>(inputFile.getFrameInfo());
 
             try
             {
-                if (!inputFile->readFrame(*frame))
+                if (!inputFile.readFrame(*frame))
                 {
                     break;
                 }
@@ -471,108 +579,303 @@ int main(int argc, char **argv)
             catch (const std::exception &e)
             {
                 vca_log(LogLevel::Error, "Error reading frame from input: " + std::string(e.what()));
-                return 3;
+                readError = true;
+                break;
             }
 
-            frame->getFrame()->stats.poc = pushedFrames;
-            vca_log(LogLevel::Debug, "Read frame " + std::to_string(pushedFrames) + " from input");
-
-            if (!options.yuviewStatsFilename.empty() && !yuviewStatsFile)
-                yuviewStatsFile = std::make_unique<YUViewStatsFile>(options.yuviewStatsFilename,
-                                                                    options.inputFilename,
-                                                                    frame->getFrame()->info);
-
-            auto ret = vca_analyzer_push(analyzer, frame->getFrame());
-            if (ret == VCA_ERROR)
-            {
-                vca_log(LogLevel::Error, "Error pushing frame to lib");
-                return 3;
-            }
+            frame->getFrame()->stats.poc = firstPoc + readCounter;
             vca_log(LogLevel::Debug,
-                    "Pushed frame " + std::to_string(pushedFrames) + " to analyzer");
+                    "Read frame " + std::to_string(firstPoc + readCounter) + " from input");
 
-            activeFrames.push(std::move(frame));
-            pushedFrames++;
+            if (!readFrames.push(std::move(frame)))
+                break;
+            readCounter++;
         }
+        readFrames.finish();
+    };
 
-        while (vca_result_available(analyzer))
+    auto writerStage = [&]() {
+        auto expectedPoc = firstPoc;
+        while (auto analyzedFrame = analyzedFrames.pop())
         {
-            Result result(frameInfo, options.vcaParam.blockSize);
+            const auto &result = *analyzedFrame->result;
+            const auto frame   = analyzedFrame->frame->getFrame();
 
-            if (vca_analyzer_pull_frame_result(analyzer, &result.result) == VCA_ERROR)
+            // The leading frames were only analyzed for the SAD and epsilon of the range start
+            if (result.poc >= int(range.start))
             {
-                vca_log(LogLevel::Error, "Error pulling frame result");
-                return 3;
+                if (!output.yuviewStatsFilename.empty() && !output.yuviewStatsFile)
+                    output.yuviewStatsFile = std::make_unique<YUViewStatsFile>(
+                        output.yuviewStatsFilename,
+                        options.inputFilename,
+                        frame->info,
+                        output.writeHeaders);
+
+                if (output.yuviewStatsFile)
+                    output.yuviewStatsFile->write(result, vcaParam.blockSize);
+                if (output.complexityFile.is_open())
+                    writeComplexityStatsToFile(result, output.complexityFile);
+                if (output.shotsFile)
+                {
+                    vca_shot_detector_push(output.shotsFile->detector, result.epsilon);
+                    writeDecidedShotsToFile(*output.shotsFile);
+                }
+                else if (!options.shotCSVFilename.empty())
+                    output.epsilonValues.push_back(result.epsilon);
+
+                printStatus(++writtenFrames, options.framesToBeAnalyzed);
             }
 
-            if (yuviewStatsFile)
-                yuviewStatsFile->write(result.result, options.vcaParam.blockSize);
-            if (complexityFile.is_open())
-                writeComplexityStatsToFile(result, complexityFile);
-            if (!options.shotCSVFilename.empty())
-                shotDetectFrames.push_back({result.result.epsilon, false});
+            logResult(result, frame, expectedPoc);
+            vca_analyzer_release_frame_result(analyzer, analyzedFrame->result);
+            inputFile.releaseFrame(*analyzedFrame->frame);
 
-            auto processedFrame = std::move(activeFrames.front());
-            activeFrames.pop();
+            frameRecycling.push(std::move(analyzedFrame->frame));
+            expectedPoc++;
+        }
+    };
 
-            logResult(result, processedFrame->getFrame(), resultsCounter);
+    std::thread readerThread(readerStage);
+    std::thread writerThread(writerStage);
 
-            frameRecycling.push(std::move(processedFrame));
-            resultsCounter++;
+    std::queue<framePtr> activeFrames;
+    unsigned pushedFrames  = 0;
+    unsigned pulledResults = 0;
+
+    auto pullResult = [&]() {
+        const vca_borrowed_frame_results *result;
+        if (vca_analyzer_borrow_frame_result(analyzer, &result) == VCA_ERROR)
+        {
+            vca_log(LogLevel::Error, "Error pulling frame result");
+            return false;
         }
 
-        printStatus(resultsCounter, options.framesToBeAnalyzed);
-    }
+        analyzedFrames.push({result, std::move(activeFrames.front())});
+        activeFrames.pop();
+        pulledResults++;
+        return true;
+    };
 
-    while (resultsCounter < pushedFrames)
+    bool analyzerError = false;
+    while (auto frame = readFrames.pop())
     {
-        Result result(frameInfo, options.vcaParam.blockSize);
-
-        if (vca_analyzer_pull_frame_result(analyzer, &result.result) == VCA_ERROR)
+        auto ret = vca_analyzer_push(analyzer, (*frame)->getFrame());
+        if (ret == VCA_ERROR)
         {
-            vca_log(LogLevel::Error, "Error pulling frame result");
-            return 3;
+            vca_log(LogLevel::Error, "Error pushing frame to lib");
+            analyzerError = true;
+            break;
         }
+        vca_log(LogLevel::Debug,
+                "Pushed frame " + std::to_string(firstPoc + pushedFrames) + " to analyzer");
 
-        if (yuviewStatsFile)
-            yuviewStatsFile->write(result.result, options.vcaParam.blockSize);
-        if (complexityFile.is_open())
-            writeComplexityStatsToFile(result, complexityFile);
-        if (!options.shotCSVFilename.empty())
-            shotDetectFrames.push_back({result.result.epsilon, false});
+        activeFrames.push(std::move(*frame));
+        pushedFrames++;
 
-        auto processedFrame = std::move(activeFrames.front());
-        activeFrames.pop();
+        while (!analyzerError && vca_result_available(analyzer))
+            analyzerError = !pullResult();
+        if (analyzerError)
+            break;
+    }
 
-        logResult(result, processedFrame->getFrame(), resultsCounter);
+    while (!analyzerError && pulledResults < pushedFrames)
+        analyzerError = !pullResult();
 
-        resultsCounter++;
+    if (analyzerError)
+    {
+        readFrames.abort();
+        analyzedFrames.abort();
     }
+    else
+        analyzedFrames.finish();
 
+    readerThread.join();
+    writerThread.join();
+
+    const auto failed = analyzerError || readError;
+    if (!failed && vcaParam.enableStats)
+        logAnalyzerStats(analyzer, range);
+
+    // After an error there may still be jobs in flight that read from the frames in
+    // activeFrames. Closing the analyzer waits for them and gives back all borrowed results, so
+    // it must happen before activeFrames goes out of scope.
     vca_analyzer_close(analyzer);
-    printStatus(resultsCounter, pushedFrames, true);
+    return failed ? 3 : 0;
+}
+
+int main(int argc, char **argv)
+{
+#if _WIN32
+    char **orgArgv = argv;
+    get_argv_utf8(&argc, &argv);
+#endif
+
+    vca_log(LogLevel::Info, "VCA - Video Complexity Analyzer " + std::string(vca_version_str));
+
+    CLIOptions options;
+    if (auto cliOptions = parseCLIOptions(argc, argv))
+        options = *cliOptions;
+    else
+    {
+        vca_log(LogLevel::Error, "Error parsing parameters");
+        return 1;
+    }
+
+    if (!checkOptions(options))
+    {
+        vca_log(LogLevel::Error, "Error checking parameters");
+        return 1;
+    }
 
+    logOptions(options);
+
+    auto inputFile = openInputFile(options, options.skipFrames);
+    if (inputFile->isFail())
+    {
+        vca_log(LogLevel::Error, "Error opening input file");
+        return 1;
+    }
+
+    auto framesInInput = inputFile->getFrameCount();
+    framesInInput      = framesInInput > options.skipFrames ? framesInInput - options.skipFrames : 0;
+    if (options.nrRanges > 1 && framesInInput == 0)
+        vca_log(LogLevel::Warning,
+                "The number of frames in the input is unknown. It can not be split into ranges.");
+
+    auto ranges = splitIntoRanges(options, framesInInput);
+    if (ranges.size() > 1)
+        vca_log(LogLevel::Info,
+                "Analyzing " + std::to_string(ranges.size()) + " ranges of frames in parallel");
+
+    // The first range writes to the output files directly. All other ranges write to their own
+    // files which are appended once all ranges are done.
+    std::vector<RangeOutput> outputs(ranges.size());
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        auto &output        = outputs[i];
+        output.writeHeaders = (i == 0);
+        if (!options.yuviewStatsFilename.empty())
+            output.yuviewStatsFilename = (i == 0) ? options.yuviewStatsFilename
+                                                  : getRangeFilename(options.yuviewStatsFilename,
+                                                                     i);
+        if (!options.complexityCSVFilename.empty())
+        {
+            auto filename = (i == 0) ? options.complexityCSVFilename
+                                     : getRangeFilename(options.complexityCSVFilename, i);
+            output.complexityFile.open(filename);
+            if (!output.complexityFile.is_open())
+            {
+                vca_log(LogLevel::Error, "Error opening complexity CSV file " + filename);
+                removeRangeFiles(options, outputs);
+                return 1;
+            }
+            if (output.writeHeaders)
+                output.complexityFile << "POC, E, h, epsilon \n";
+        }
+    }
+
+    options.vcaParam.logFunction        = logLibraryMessage;
+    options.shotDetectParam.logFunction = logLibraryMessage;
+
+    ShotsFile shotsFile;
     if (!options.shotCSVFilename.empty())
     {
+        shotsFile.file.open(options.shotCSVFilename);
+        if (!shotsFile.file.is_open())
+        {
+            vca_log(LogLevel::Error, "Error opening shot CSV file " + options.shotCSVFilename);
+            removeRangeFiles(options, outputs);
+            return 1;
+        }
+        shotsFile.file << "ID, Start POC \n";
+
         if (options.shotDetectParam.fps == 0.0)
             options.shotDetectParam.fps = inputFile->getFPS();
+        shotsFile.detector   = vca_shot_detector_open(options.shotDetectParam);
+        outputs[0].shotsFile = &shotsFile;
+    }
 
-        vca_shot_detection(options.shotDetectParam,
-                           shotDetectFrames.data(),
-                           shotDetectFrames.size());
+    auto rangeParam = options.vcaParam;
+    if (ranges.size() > 1 && rangeParam.nrFrameThreads == 0)
+        rangeParam.nrFrameThreads = std::max(std::thread::hardware_concurrency()
+                                                 / unsigned(ranges.size()),
+                                             1u);
 
-        std::ofstream shotsFile;
-        shotsFile.open(options.shotCSVFilename);
-        if (!shotsFile.is_open())
+    /* Control-C handler */
+    if (signal(SIGINT, sigint_handler) == SIG_ERR)
+        vca_log(LogLevel::Error,
+                "Unable to register CTRL+C handler: " + std::string(strerror(errno)));
+
+    std::atomic<unsigned> writtenFrames{};
+    std::vector<int> rangeResults(ranges.size());
+    std::vector<std::thread> rangeThreads;
+    for (size_t i = 1; i < ranges.size(); i++)
+        rangeThreads.emplace_back([&, i]() {
+            const auto &range   = ranges[i];
+            auto rangeInputFile = openInputFile(options,
+                                                options.skipFrames + range.start
+                                                    - range.leadingFrames);
+            if (rangeInputFile->isFail())
+            {
+                vca_log(LogLevel::Error, "Error opening input file");
+                rangeResults[i] = 1;
+                return;
+            }
+            rangeResults[i] = analyzeRange(options,
+                                           rangeParam,
+                                           range,
+                                           *rangeInputFile,
+                                           outputs[i],
+                                           writtenFrames);
+        });
+
+    rangeResults[0] = analyzeRange(options,
+                                   rangeParam,
+                                   ranges[0],
+                                   *inputFile,
+                                   outputs[0],
+                                   writtenFrames);
+    for (auto &thread : rangeThreads)
+        thread.join();
+
+    for (auto result : rangeResults)
+    {
+        if (result != 0)
         {
-            vca_log(LogLevel::Error, "Error opening shot CSV file " + options.shotCSVFilename);
-            return 1;
+            removeRangeFiles(options, outputs);
+            return result;
         }
-        shotsFile << "ID, Start POC \n";
-        writeShotDetectionResultsToFile(shotDetectFrames, shotsFile);
+    }
+
+    printStatus(writtenFrames, writtenFrames, true);
+
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        auto &output = outputs[i];
+        output.complexityFile.close();
+        output.yuviewStatsFile.reset();
+
+        if (i > 0 && !options.complexityCSVFilename.empty())
+            appendRangeFile(options.complexityCSVFilename, i);
+        if (i > 0 && !options.yuviewStatsFilename.empty())
+            appendRangeFile(options.yuviewStatsFilename, i);
+
+        if (shotsFile.detector)
+        {
+            for (auto epsilon : output.epsilonValues)
+                vca_shot_detector_push(shotsFile.detector, epsilon);
+            writeDecidedShotsToFile(shotsFile);
+        }
+    }
+
+    if (shotsFile.detector)
+    {
+        vca_shot_detector_flush(shotsFile.detector);
+        writeDecidedShotsToFile(shotsFile);
+        vca_shot_detector_close(shotsFile.detector);
 
         vca_log(LogLevel::Info,
-                "Performed shot detection for " + std::to_string(shotDetectFrames.size())
+                "Performed shot detection for " + std::to_string(shotsFile.frameCounter)
                     + " frames.");
     }
 
@@ -29,11 +29,14 @@ static const struct option long_options[] = {{"help", no_argument, NULL, 'h'},
                                              {"asm", required_argument, NULL, 0},
                                              {"no-asm", no_argument, NULL, 0},
                                              {"input", required_argument, NULL, 0},
+                                             {"y4m", no_argument, NULL, 0},
                                              {"input-depth", required_argument, NULL, 0},
                                              {"input-res", required_argument, NULL, 0},
                                              {"input-csp", required_argument, NULL, 0},
                                              {"input-fps", required_argument, NULL, 0},
                                              {"skip", required_argument, NULL, 0},
+                                             {"no-mmap", no_argument, NULL, 0},
+                                             {"read-ahead", required_argument, NULL, 0},
                                              {"frames", required_argument, NULL, 'f'},
                                              {"complexity-csv", required_argument, NULL, 0},
                                              {"shot-csv", required_argument, NULL, 0},
@@ -42,10 +45,9 @@ static const struct option long_options[] = {{"help", no_argument, NULL, 'h'},
                                              {"min-thresh", required_argument, NULL, 0},
                                              {"block-size", required_argument, NULL, 0},
                                              {"threads", required_argument, NULL, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
+                                             {"slice-threads", required_argument, NULL, 0},
+                                             {"ranges", required_argument, NULL, 0},
+                                             {"stats", no_argument, NULL, 0},
                                              {0, 0, 0, 0}};
 
 static void showHelp()
@@ -70,6 +72,9 @@ static void showHelp()
     printf("-f/--frames <integer>            Maximum number of frames to analyze. Default all\n");
     printf("   --skip <integer>              Skip N frames in the input before starting the "
            "analysis\n");
+    printf("   --no-mmap                     Read the input file instead of memory mapping it\n");
+    printf("   --read-ahead <integer>        Nr of frames that are read ahead of the analysis. "
+           "Default 8\n");
     printf("\nOutput Options:\n");
     printf("   --complexity-csv <filename>   Comma separated complexity log file\n");
     printf("   --shot-csv <filename>         Comma separated shot detection log file.\n");
@@ -77,6 +82,7 @@ static void showHelp()
     printf("   --yuview-stats <filename>     Write the per block results (energy, sad) to a stats "
            "file\n");
     printf("                                 that can be visualized using YUView.\n");
+    printf("   --stats                       Log timing statistics of the analyzer at the end\n");
     printf("\nOperation Options:\n");
     printf("   --[no-]asm                    Enable / disable ASM. Default: Enabled\n");
     printf("   --max-thresh <float>          Maximum threshold of epsilon in shot detection\n");
@@ -84,4 +90,10 @@ static void showHelp()
     printf("   --block-size <integer>        Block size for DCT transform. Must be 8, 16 or 32 "
            "(Default).\n");
     printf("   --threads <integer>           Nr of threads to use. (Default: 0 (autodetect))\n");
+    printf("   --slice-threads <integer>     Split each frame into N slices which are analyzed "
+           "in\n");
+    printf("                                 parallel. (Default: 0 (disabled))\n");
+    printf("   --ranges <integer>            Split the input into N ranges of frames which are "
+           "analyzed\n");
+    printf("                                 in parallel by separate analyzers. (Default: 1)\n");
 }
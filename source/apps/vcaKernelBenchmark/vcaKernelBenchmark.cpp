@@ -0,0 +1,774 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "vcacli.h"
+
+#include <common/common.h>
+#include <lib/analyzer/DCTTransforms.h>
+#include <lib/analyzer/EnergyCalculation.h>
+#include <lib/analyzer/Primitives.h>
+#include <lib/analyzer/Stats.h>
+#include <lib/analyzer/simd/cpu.h>
+#include <lib/analyzer/simd/dct-avx2.h>
+#include <lib/analyzer/simd/dct-avx512.h>
+#include <lib/analyzer/simd/dct-sse2.h>
+#include <lib/analyzer/simd/dct-ssse3.h>
+#include <lib/analyzer/simd/dct8.h>
+#include <lib/vcaLib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+
+using namespace vca;
+using namespace std::string_literals;
+
+namespace {
+
+// The cold cache measurements process the blocks of a buffer of this size in random order, so
+// that (almost) every block has to be loaded from memory. This must be larger than the last
+// level cache.
+constexpr size_t ColdBufferBytes = 128 * 1024 * 1024;
+
+// The SAD is calculated per frame. Use the number of blocks of a 1080p frame.
+const vca_frame_info SADFrameInfo = {1920, 1080, 8, vca_colorSpace::YUV420};
+
+const std::map<CpuSimd, std::string> cpuSimdNames = {{CpuSimd::None, "None"},
+                                                     {CpuSimd::SSE2, "SSE2"},
+                                                     {CpuSimd::SSSE3, "SSSE3"},
+                                                     {CpuSimd::SSE4, "SSE4"},
+                                                     {CpuSimd::AVX2, "AVX2"},
+                                                     {CpuSimd::AVX512, "AVX512"}};
+
+#if ENABLE_NASM
+constexpr bool NasmKernelsAvailable = true;
+#else
+constexpr bool NasmKernelsAvailable = false;
+#endif
+
+} // namespace
+
+struct CLIOptions
+{
+    unsigned iterations{100000};
+    unsigned repetitions{5};
+    std::string filter;
+    std::string jsonFilename;
+};
+
+std::optional<CLIOptions> parseCLIOptions(int argc, char **argv)
+{
+    CLIOptions options;
+
+    int long_options_index = -1;
+    while (true)
+    {
+        auto c = getopt_long(argc, argv, short_options, long_options, &long_options_index);
+        if (c == -1)
+            break;
+
+        if (c == 'h')
+        {
+            showHelp();
+            return {};
+        }
+
+        if (long_options_index < 0 && c > 0)
+        {
+            for (size_t i = 0; i < sizeof(long_options) / sizeof(long_options[0]); i++)
+            {
+                if (long_options[i].val == c)
+                {
+                    long_options_index = (int) i;
+                    break;
+                }
+            }
+
+            if (long_options_index < 0)
+            {
+                /* getopt_long might have already printed an error message */
+                if (c != 63)
+                    vca_log(LogLevel::Warning,
+                            "internal error: short option " + std::string(1, c)
+                                + " has no long option");
+                return {};
+            }
+        }
+        if (long_options_index < 0)
+        {
+            vca_log(LogLevel::Warning, "short option " + std::string(1, c) + " unrecognized");
+            return {};
+        }
+
+        auto name = std::string(long_options[long_options_index].name);
+        if (name == "iterations")
+            options.iterations = std::stoul(optarg);
+        else if (name == "repetitions")
+            options.repetitions = std::stoul(optarg);
+        else if (name == "filter")
+            options.filter = optarg;
+        else if (name == "json")
+            options.jsonFilename = optarg;
+
+        long_options_index = -1;
+    }
+
+    return options;
+}
+
+bool checkOptions(const CLIOptions &options)
+{
+    if (options.iterations == 0 || options.repetitions == 0)
+    {
+        vca_log(LogLevel::Error, "The iterations and repetitions must be at least 1.");
+        return false;
+    }
+    return true;
+}
+
+// A buffer with 64 byte aligned samples
+template<class T>
+class AlignedBuffer
+{
+public:
+    AlignedBuffer(size_t size) : data(size + 64 / sizeof(T))
+    {
+        void *start = this->data.data();
+        auto space  = this->data.size() * sizeof(T);
+        std::align(64, size * sizeof(T), start, space);
+        this->alignedData = (T *) (start);
+    }
+
+    T *get() const
+    {
+        return this->alignedData;
+    }
+
+private:
+    std::vector<T> data;
+    T *alignedData{};
+};
+
+// The input of the block kernels. The blocks are stored one after another with a stride of
+// the block size. All samples are in the range of 8 bit values so that the same data can be
+// used for all sample types.
+class BlockData
+{
+public:
+    BlockData() : samples(ColdBufferBytes / 2)
+    {
+        std::default_random_engine randomEngine(42);
+        std::uniform_int_distribution<int> uniformDist(0, 255);
+        for (size_t i = 0; i < ColdBufferBytes / 2; i++)
+            this->samples.get()[i] = uint16_t(uniformDist(randomEngine));
+    }
+
+    size_t getNrBlocks(unsigned blockSize, size_t bytesPerSample) const
+    {
+        return ColdBufferBytes / (blockSize * blockSize * bytesPerSample);
+    }
+
+    template<class T>
+    const T *getBlock(unsigned blockSize, size_t blockIndex) const
+    {
+        return (const T *) (this->samples.get()) + blockIndex * blockSize * blockSize;
+    }
+
+private:
+    AlignedBuffer<uint16_t> samples;
+};
+
+// Process the units (blocks or frames) given by the indices in order
+using RunFunction = std::function<void(const uint32_t *order, size_t count)>;
+
+struct Kernel
+{
+    Kernel(std::string name,
+           std::string group,
+           unsigned blockSize,
+           CpuSimd requiredSimd = CpuSimd::None,
+           bool needsNasm       = false)
+        : name(std::move(name))
+        , group(std::move(group))
+        , blockSize(blockSize)
+        , requiredSimd(requiredSimd)
+        , needsNasm(needsNasm)
+    {
+    }
+
+    std::string name;
+    std::string group;
+    unsigned blockSize{};
+
+    CpuSimd requiredSimd{CpuSimd::None};
+    bool needsNasm{};
+
+    // The number of units that fit into the cold buffer and the number of blocks per unit
+    size_t nrUnits{};
+    size_t blocksPerUnit{1};
+
+    RunFunction run;
+    // Optional. Allocate and free the data that is only needed while the kernel is measured.
+    std::function<void()> prepare;
+    std::function<void()> release;
+};
+
+struct Measurement
+{
+    double ticksPerBlock{};
+    double nsPerBlock{};
+};
+
+struct BenchmarkResult
+{
+    const Kernel *kernel{};
+    Measurement warm;
+    Measurement cold;
+};
+
+template<class T>
+Kernel makeDCTKernel(std::string name,
+                     unsigned blockSize,
+                     CpuSimd requiredSimd,
+                     bool needsNasm,
+                     void (*dct)(const T *, int16_t *, intptr_t),
+                     const BlockData &data,
+                     int16_t *coeffBuffer)
+{
+    Kernel kernel{std::move(name), "dct", blockSize, requiredSimd, needsNasm};
+    kernel.nrUnits = data.getNrBlocks(blockSize, sizeof(T));
+    kernel.run     = [&data, dct, blockSize, coeffBuffer](const uint32_t *order, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            dct(data.getBlock<T>(blockSize, order[i]), coeffBuffer, blockSize);
+    };
+    return kernel;
+}
+
+Kernel makeHighBitDepthDCTKernel(std::string name,
+                                 unsigned blockSize,
+                                 CpuSimd requiredSimd,
+                                 void (*dct)(const uint16_t *, int16_t *, intptr_t, unsigned),
+                                 const BlockData &data,
+                                 int16_t *coeffBuffer)
+{
+    Kernel kernel{std::move(name), "dct", blockSize, requiredSimd, false};
+    kernel.nrUnits = data.getNrBlocks(blockSize, 2);
+    kernel.run     = [&data, dct, blockSize, coeffBuffer](const uint32_t *order, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            dct(data.getBlock<uint16_t>(blockSize, order[i]), coeffBuffer, blockSize, 10);
+    };
+    return kernel;
+}
+
+// The batched 8x8 kernels read 4 adjacent blocks. Each unit is a strip of 32x8 samples.
+template<class T>
+Kernel makeEnergy8x4Kernel(std::string name,
+                           void (*energy8x4)(const T *, intptr_t, uint32_t *),
+                           const BlockData &data)
+{
+    Kernel kernel{std::move(name), "energy", 8, CpuSimd::AVX2, false};
+    kernel.nrUnits       = data.getNrBlocks(8, sizeof(T)) / 4;
+    kernel.blocksPerUnit = 4;
+    kernel.run           = [&data, energy8x4](const uint32_t *order, size_t count) {
+        uint32_t energies[4];
+        uint32_t sum = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            energy8x4(data.getBlock<T>(8, 4 * size_t(order[i])), 32, energies);
+            sum += energies[0];
+        }
+        // Keep the compiler from dropping the calls
+        volatile uint32_t sink = sum;
+        (void) sink;
+    };
+    return kernel;
+}
+
+// Results with random energies. Each result is compared to the next one.
+void fillSADResults(std::vector<Result> &results, size_t nrResults, size_t blocksPerFrame)
+{
+    std::default_random_engine randomEngine(42);
+    std::uniform_int_distribution<uint32_t> uniformDist(0, 10000);
+
+    results.resize(nrResults);
+    for (auto &result : results)
+    {
+        result.energyPerBlock.resize(blocksPerFrame);
+        result.sadPerBlock.resize(blocksPerFrame);
+        for (auto &energy : result.energyPerBlock)
+            energy = uniformDist(randomEngine);
+    }
+}
+
+std::vector<Kernel> createKernels(const BlockData &data, int16_t *pixelBuffer, int16_t *coeffBuffer)
+{
+    std::vector<Kernel> kernels;
+
+    const auto None   = CpuSimd::None;
+    const auto SSE2   = CpuSimd::SSE2;
+    const auto SSSE3  = CpuSimd::SSSE3;
+    const auto SSE4   = CpuSimd::SSE4;
+    const auto AVX2   = CpuSimd::AVX2;
+    const auto AVX512 = CpuSimd::AVX512;
+
+    kernels.push_back(makeDCTKernel("dct8_c", 8, None, false, dct8_c, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct8_sse2", 8, SSE2, true, vca_dct8_sse2, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct8_sse4", 8, SSE4, true, vca_dct8_sse4, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct8_avx2", 8, AVX2, true, vca_dct8_avx2, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct8_intrin_sse2", 8, SSE2, false, vca_dct8_intrin_sse2, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct8_intrin_avx2", 8, AVX2, false, vca_dct8_intrin_avx2, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct8_avx512", 8, AVX512, false, vca_dct8_avx512, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct8_u8_c", 8, None, false, dct8_u8_c, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct8_u8_sse2", 8, SSE2, false, vca_dct8_u8_sse2, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct8_u8_avx2", 8, AVX2, false, vca_dct8_u8_avx2, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct8_u8_avx512", 8, AVX512, false, vca_dct8_u8_avx512, data, coeffBuffer));
+    kernels.push_back(
+        makeHighBitDepthDCTKernel("dct8_u16_c", 8, None, dct8_u16_c, data, coeffBuffer));
+    kernels.push_back(
+        makeHighBitDepthDCTKernel("dct8_u16_sse2", 8, SSE2, vca_dct8_u16_sse2, data, coeffBuffer));
+    kernels.push_back(
+        makeHighBitDepthDCTKernel("dct8_u16_avx2", 8, AVX2, vca_dct8_u16_avx2, data, coeffBuffer));
+    kernels.push_back(makeHighBitDepthDCTKernel("dct8_u16_avx512",
+                                                8,
+                                                AVX512,
+                                                vca_dct8_u16_avx512,
+                                                data,
+                                                coeffBuffer));
+
+
+    // Any weights in the valid range give the same timing
+    static const std::vector<uint16_t> weights(64, uint16_t(128 << 8));
+    kernels.push_back(makeEnergy8x4Kernel<uint8_t>(
+        "dct8_energy4_u8_avx2",
+        [](const uint8_t *src, intptr_t stride, uint32_t *energies) {
+            vca_dct8_energy4_u8_avx2(src, stride, weights.data(), energies);
+        },
+        data));
+    kernels.push_back(makeEnergy8x4Kernel<uint16_t>(
+        "dct8_energy4_u16_avx2",
+        [](const uint16_t *src, intptr_t stride, uint32_t *energies) {
+            vca_dct8_energy4_u16_avx2(src, stride, weights.data(), energies, 10);
+        },
+        data));
+
+    kernels.push_back(makeDCTKernel("dct16_c", 16, None, false, dct16_c, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct16_ssse3", 16, SSSE3, false, vca_dct16_ssse3, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct16_avx2", 16, AVX2, true, vca_dct16_avx2, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct16_intrin_avx2",
+                                    16,
+                                    AVX2,
+                                    false,
+                                    vca_dct16_intrin_avx2,
+                                    data,
+                                    coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct16_avx512", 16, AVX512, false, vca_dct16_avx512, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct16_u8_c", 16, None, false, dct16_u8_c, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct16_u8_ssse3", 16, SSSE3, false, vca_dct16_u8_ssse3, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct16_u8_avx2", 16, AVX2, false, vca_dct16_u8_avx2, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct16_u8_avx512",
+                                    16,
+                                    AVX512,
+                                    false,
+                                    vca_dct16_u8_avx512,
+                                    data,
+                                    coeffBuffer));
+    kernels.push_back(
+        makeHighBitDepthDCTKernel("dct16_u16_c", 16, None, dct16_u16_c, data, coeffBuffer));
+    kernels.push_back(makeHighBitDepthDCTKernel("dct16_u16_ssse3",
+                                                16,
+                                                SSSE3,
+                                                vca_dct16_u16_ssse3,
+                                                data,
+                                                coeffBuffer));
+    kernels.push_back(makeHighBitDepthDCTKernel("dct16_u16_avx2",
+                                                16,
+                                                AVX2,
+                                                vca_dct16_u16_avx2,
+                                                data,
+                                                coeffBuffer));
+    kernels.push_back(makeHighBitDepthDCTKernel("dct16_u16_avx512",
+                                                16,
+                                                AVX512,
+                                                vca_dct16_u16_avx512,
+                                                data,
+                                                coeffBuffer));
+
+    kernels.push_back(makeDCTKernel("dct32_c", 32, None, false, dct32_c, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct32_ssse3", 32, SSSE3, false, vca_dct32_ssse3, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct32_avx2", 32, AVX2, true, vca_dct32_avx2, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct32_intrin_avx2",
+                                    32,
+                                    AVX2,
+                                    false,
+                                    vca_dct32_intrin_avx2,
+                                    data,
+                                    coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct32_avx512", 32, AVX512, false, vca_dct32_avx512, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct32_u8_c", 32, None, false, dct32_u8_c, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct32_u8_ssse3", 32, SSSE3, false, vca_dct32_u8_ssse3, data, coeffBuffer));
+    kernels.push_back(
+        makeDCTKernel("dct32_u8_avx2", 32, AVX2, false, vca_dct32_u8_avx2, data, coeffBuffer));
+    kernels.push_back(makeDCTKernel("dct32_u8_avx512",
+                                    32,
+                                    AVX512,
+                                    false,
+                                    vca_dct32_u8_avx512,
+                                    data,
+                                    coeffBuffer));
+    kernels.push_back(
+        makeHighBitDepthDCTKernel("dct32_u16_c", 32, None, dct32_u16_c, data, coeffBuffer));
+    kernels.push_back(makeHighBitDepthDCTKernel("dct32_u16_ssse3",
+                                                32,
+                                                SSSE3,
+                                                vca_dct32_u16_ssse3,
+                                                data,
+                                                coeffBuffer));
+    kernels.push_back(makeHighBitDepthDCTKernel("dct32_u16_avx2",
+                                                32,
+                                                AVX2,
+                                                vca_dct32_u16_avx2,
+                                                data,
+                                                coeffBuffer));
+    kernels.push_back(makeHighBitDepthDCTKernel("dct32_u16_avx512",
+                                                32,
+                                                AVX512,
+                                                vca_dct32_u16_avx512,
+                                                data,
+                                                coeffBuffer));
+
+    for (unsigned blockSize : {8u, 16u, 32u})
+    {
+        const auto sizeName = std::to_string(blockSize);
+
+        Kernel copy{"copyPixelValuesToBuffer" + sizeName, "copy", blockSize};
+        copy.nrUnits = data.getNrBlocks(blockSize, 1);
+        copy.run     = [&data, blockSize, pixelBuffer](const uint32_t *order, size_t count) {
+            for (size_t i = 0; i < count; i++)
+                copyPixelValuesToBuffer(data.getBlock<uint8_t>(blockSize, order[i]),
+                                        blockSize,
+                                        blockSize,
+                                        pixelBuffer);
+        };
+        kernels.push_back(std::move(copy));
+
+        // The padding is only needed at the border. Pad the right and bottom half of the block.
+        const auto padding = blockSize / 2;
+
+        Kernel copyPadding8{"copyPixelValuesToBufferWithPadding" + sizeName + "_8bit",
+                            "copy",
+                            blockSize};
+        copyPadding8.nrUnits = data.getNrBlocks(blockSize, 1);
+        copyPadding8.run     = [&data, blockSize, padding, pixelBuffer](const uint32_t *order,
+                                                                    size_t count) {
+            for (size_t i = 0; i < count; i++)
+                copyPixelValuesToBufferWithPadding<8>(
+                    0,
+                    blockSize,
+                    (uint8_t *) (data.getBlock<uint8_t>(blockSize, order[i])),
+                    blockSize,
+                    pixelBuffer,
+                    padding,
+                    padding);
+        };
+        kernels.push_back(std::move(copyPadding8));
+
+        Kernel copyPadding16{"copyPixelValuesToBufferWithPadding" + sizeName + "_16bit",
+                             "copy",
+                             blockSize};
+        copyPadding16.nrUnits = data.getNrBlocks(blockSize, 2);
+        copyPadding16.run     = [&data, blockSize, padding, pixelBuffer](const uint32_t *order,
+                                                                     size_t count) {
+            for (size_t i = 0; i < count; i++)
+                copyPixelValuesToBufferWithPadding<16>(
+                    0,
+                    blockSize,
+                    (uint8_t *) (data.getBlock<uint16_t>(blockSize, order[i])),
+                    blockSize,
+                    pixelBuffer,
+                    padding,
+                    padding);
+        };
+        kernels.push_back(std::move(copyPadding16));
+
+        for (auto [simd, simdName] : {std::make_pair(None, "c"s),
+                                      std::make_pair(SSSE3, "ssse3"s),
+                                      std::make_pair(AVX2, "avx2"s),
+                                      std::make_pair(AVX512, "avx512"s)})
+        {
+            EnergyPrimitives primitives;
+            setupEnergyPrimitives(primitives, simd);
+
+            Kernel weightedSum{"weightedSum" + sizeName + "_" + simdName,
+                               "weightedSum",
+                               blockSize,
+                               simd};
+            weightedSum.nrUnits = data.getNrBlocks(blockSize, 2);
+            weightedSum.run     = [&data, blockSize, primitives](const uint32_t *order,
+                                                             size_t count) {
+                const auto weights = primitives.get(blockSize).weights;
+                uint32_t sum       = 0;
+                for (size_t i = 0; i < count; i++)
+                    sum += primitives.weightedSum(data.getBlock<int16_t>(blockSize, order[i]),
+                                                  weights,
+                                                  blockSize * blockSize);
+                // Keep the compiler from dropping the calls
+                volatile uint32_t sink = sum;
+                (void) sink;
+            };
+            kernels.push_back(std::move(weightedSum));
+        }
+
+        auto [widthInBlocks, heightInBlocks] = getFrameSizeInBlocks(blockSize, SADFrameInfo);
+        const auto blocksPerFrame            = size_t(widthInBlocks) * heightInBlocks;
+
+        auto sadResults = std::make_shared<std::vector<Result>>();
+
+        Kernel sad{"computeTextureSAD" + sizeName, "sad", blockSize};
+        sad.nrUnits       = ColdBufferBytes / (blocksPerFrame * 2 * sizeof(uint32_t));
+        sad.blocksPerUnit = blocksPerFrame;
+        sad.run           = [sadResults](const uint32_t *order, size_t count) {
+            auto &results = *sadResults;
+            for (size_t i = 0; i < count; i++)
+                computeTextureSAD(results[order[i]], results[(order[i] + 1) % results.size()]);
+        };
+        sad.prepare = [sadResults, nrResults = sad.nrUnits, blocksPerFrame]() {
+            fillSADResults(*sadResults, nrResults, blocksPerFrame);
+        };
+        sad.release = [sadResults]() { std::vector<Result>().swap(*sadResults); };
+        kernels.push_back(std::move(sad));
+    }
+
+    return kernels;
+}
+
+// The order in which the units are processed. For the warm cache the same unit is processed
+// over and over. For the cold cache the units are processed in a random order so that the
+// hardware prefetcher can not help.
+std::vector<uint32_t> createOrder(size_t length, size_t nrUnits, bool cold)
+{
+    std::vector<uint32_t> order(length, 0);
+    if (!cold)
+        return order;
+
+    std::vector<uint32_t> permutation(nrUnits);
+    for (size_t i = 0; i < nrUnits; i++)
+        permutation[i] = uint32_t(i);
+
+    std::default_random_engine randomEngine(42);
+    for (size_t start = 0; start < length; start += nrUnits)
+    {
+        std::shuffle(permutation.begin(), permutation.end(), randomEngine);
+        std::copy_n(permutation.begin(), std::min(nrUnits, length - start), order.begin() + start);
+    }
+    return order;
+}
+
+// Run the kernel once to warm up and then repetitions times. Each run continues in the order
+// where the previous one stopped. Returns the median.
+Measurement measure(const Kernel &kernel,
+                    const CLIOptions &options,
+                    const std::vector<uint32_t> &order,
+                    size_t unitsPerRun)
+{
+    std::vector<double> ticksPerBlock;
+    std::vector<double> nsPerBlock;
+    const auto blocksPerRun = double(unitsPerRun * kernel.blocksPerUnit);
+    for (unsigned repetition = 0; repetition <= options.repetitions; repetition++)
+    {
+        const auto runOrder = order.data() + repetition * unitsPerRun;
+
+        auto startTime  = std::chrono::steady_clock::now();
+        auto startTicks = readTicks();
+        kernel.run(runOrder, unitsPerRun);
+        auto ticks    = readTicks() - startTicks;
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime);
+
+        if (repetition == 0)
+            continue;
+        ticksPerBlock.push_back(double(ticks) / blocksPerRun);
+        nsPerBlock.push_back(double(duration.count()) / blocksPerRun);
+    }
+
+    auto median = [](std::vector<double> &values) {
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+    return {median(ticksPerBlock), median(nsPerBlock)};
+}
+
+BenchmarkResult runKernel(const Kernel &kernel, const CLIOptions &options)
+{
+    // The SAD processes a whole frame per unit
+    const auto unitsPerRun = std::max(options.iterations / kernel.blocksPerUnit, size_t(1));
+    const auto orderLength = unitsPerRun * (options.repetitions + 1);
+
+    if (kernel.prepare)
+        kernel.prepare();
+
+    BenchmarkResult result;
+    result.kernel = &kernel;
+    result.warm   = measure(kernel,
+                          options,
+                          createOrder(orderLength, kernel.nrUnits, false),
+                          unitsPerRun);
+    result.cold   = measure(kernel,
+                          options,
+                          createOrder(orderLength, kernel.nrUnits, true),
+                          unitsPerRun);
+
+    if (kernel.release)
+        kernel.release();
+    return result;
+}
+
+void writeJSON(std::ostream &out,
+               const std::vector<BenchmarkResult> &results,
+               const CLIOptions &options,
+               CpuSimd detectedSimd)
+{
+    auto writeMeasurement = [&out](const std::string &name, const Measurement &measurement) {
+        out << "\"" << name << "\": {\"ticksPerBlock\": " << measurement.ticksPerBlock
+            << ", \"nsPerBlock\": " << measurement.nsPerBlock << "}";
+    };
+
+    out << std::fixed << std::setprecision(2);
+    out << "{\n";
+    out << "  \"version\": \"" << vca_version_str << "\",\n";
+    out << "  \"simd\": \"" << cpuSimdNames.at(detectedSimd) << "\",\n";
+    out << "  \"nasm\": " << (NasmKernelsAvailable ? "true" : "false") << ",\n";
+    out << "  \"iterations\": " << options.iterations << ",\n";
+    out << "  \"repetitions\": " << options.repetitions << ",\n";
+    out << "  \"kernels\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const auto &result = results[i];
+        out << "    {\"name\": \"" << result.kernel->name << "\", \"group\": \""
+            << result.kernel->group << "\", \"blockSize\": " << result.kernel->blockSize << ", ";
+        writeMeasurement("warm", result.warm);
+        out << ", ";
+        writeMeasurement("cold", result.cold);
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+int main(int argc, char **argv)
+{
+    CLIOptions options;
+    if (auto cliOptions = parseCLIOptions(argc, argv))
+        options = *cliOptions;
+    else
+    {
+        vca_log(LogLevel::Error, "Error parsing parameters");
+        return 1;
+    }
+
+    if (!checkOptions(options))
+    {
+        vca_log(LogLevel::Error, "Error checking parameters");
+        return 1;
+    }
+
+    // If the JSON goes to stdout, nothing else may be printed there
+    const auto writeToStdout = options.jsonFilename == "-";
+    auto log                 = [writeToStdout](const std::string &message) {
+        if (!writeToStdout)
+            vca_log(LogLevel::Info, message);
+    };
+
+    log("VCA - Kernel benchmark " + std::string(vca_version_str));
+
+    const auto detectedSimd = cpuDetectMaxSimd();
+    log("Detected SIMD " + cpuSimdNames.at(detectedSimd));
+    if (!NasmKernelsAvailable)
+        log("The library was built without NASM. Skipping the assembly kernels.");
+
+    BlockData data;
+    ALIGN_VAR_64(int16_t, pixelBuffer[32 * 32]);
+    ALIGN_VAR_64(int16_t, coeffBuffer[32 * 32]);
+
+    auto kernels = createKernels(data, pixelBuffer, coeffBuffer);
+
+    std::vector<BenchmarkResult> results;
+    for (const auto &kernel : kernels)
+    {
+        if (!options.filter.empty() && kernel.name.find(options.filter) == std::string::npos)
+            continue;
+        if (kernel.needsNasm && !NasmKernelsAvailable)
+            continue;
+        if (kernel.requiredSimd > detectedSimd)
+        {
+            log("Skipping " + kernel.name + ". Needs " + cpuSimdNames.at(kernel.requiredSimd));
+            continue;
+        }
+
+        results.push_back(runKernel(kernel, options));
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << std::left << std::setw(44) << kernel.name
+             << " warm " << std::right << std::setw(8) << results.back().warm.ticksPerBlock
+             << " ticks/block, cold " << std::setw(8) << results.back().cold.ticksPerBlock
+             << " ticks/block";
+        log(line.str());
+    }
+
+    if (options.jsonFilename.empty())
+        return 0;
+
+    if (writeToStdout)
+        writeJSON(std::cout, results, options, detectedSimd);
+    else
+    {
+        std::ofstream file(options.jsonFilename);
+        if (!file.is_open())
+        {
+            vca_log(LogLevel::Error, "Error opening JSON file " + options.jsonFilename);
+            return 1;
+        }
+        writeJSON(file, results, options, detectedSimd);
+        log("Wrote results to " + options.jsonFilename);
+    }
+
+    return 0;
+}
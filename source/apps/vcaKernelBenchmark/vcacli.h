@@ -0,0 +1,49 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <common/getopt/getopt.h>
+
+#include <stdio.h>
+
+static const char short_options[]         = "N:h?";
+static const struct option long_options[] = {{"help", no_argument, NULL, 'h'},
+                                             {"iterations", required_argument, NULL, 'N'},
+                                             {"repetitions", required_argument, NULL, 0},
+                                             {"filter", required_argument, NULL, 0},
+                                             {"json", required_argument, NULL, 0},
+                                             {0, 0, 0, 0}};
+
+static void showHelp()
+{
+    printf("\nSyntax: vcaKernelBenchmark [options]\n");
+    printf("    Time the DCT and energy kernels in isolation.\n");
+    printf("\nExecutable Options:\n");
+    printf("-h/--help                        Show this help text and exit\n");
+    printf("\nOptions:\n");
+    printf("-N/--iterations <integer>        How many blocks are processed per measurement. "
+           "(Default 100000)\n");
+    printf("   --repetitions <integer>       How often each measurement is repeated. The median "
+           "is\n");
+    printf("                                 reported. (Default 5)\n");
+    printf("   --filter <string>             Only run the kernels whose name contains this "
+           "string\n");
+    printf("   --json <filename>             Write the results to a JSON file. `-` for stdout\n");
+}
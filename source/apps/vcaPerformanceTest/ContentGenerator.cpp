@@ -0,0 +1,303 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "ContentGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace vca {
+
+namespace {
+
+constexpr double Pi = 3.14159265358979323846;
+
+struct Wave
+{
+    // Angular frequency in x and y direction (radians per luma sample)
+    double frequencyX{};
+    double frequencyY{};
+    double phase{};
+    double amplitude{};
+    // Motion in luma samples per frame
+    double motionX{};
+    double motionY{};
+};
+
+// The parameters of one scene. All frames of a scene show the same content with motion.
+struct Scene
+{
+    std::vector<Wave> textureA;
+    std::vector<Wave> textureB;
+    double gradientAngle{};
+    double gradientPeriods{};
+    double gradientSpeed{};
+    double flatLevel{};
+    double chromaOffsetU{};
+    double chromaOffsetV{};
+    double noise{};
+};
+
+Scene createScene(unsigned seed, unsigned sceneIndex)
+{
+    std::mt19937 randomEngine(seed * 1000003u + sceneIndex);
+    auto uniform = [&randomEngine](double min, double max) {
+        return std::uniform_real_distribution<double>(min, max)(randomEngine);
+    };
+
+    // The amount of detail differs a lot between scenes
+    const auto contrast = uniform(0.05, 0.4);
+
+    auto createWaves = [&](unsigned nrWaves, double minPeriod, double maxPeriod) {
+        std::vector<Wave> waves(nrWaves);
+        const auto motionX = uniform(-0.5, 0.5);
+        const auto motionY = uniform(-0.25, 0.25);
+        for (auto &wave : waves)
+        {
+            const auto period    = uniform(minPeriod, maxPeriod);
+            const auto direction = uniform(0, Pi);
+            wave.frequencyX      = 2 * Pi / period * std::cos(direction);
+            wave.frequencyY      = 2 * Pi / period * std::sin(direction);
+            wave.phase           = uniform(0, 2 * Pi);
+            wave.amplitude       = uniform(0.5, 1.0) * contrast / nrWaves;
+            wave.motionX         = motionX;
+            wave.motionY         = motionY;
+        }
+        return waves;
+    };
+
+    Scene scene;
+    scene.textureA        = createWaves(3, 8, 64);
+    scene.textureB        = createWaves(2, 3, 12);
+    scene.gradientAngle   = uniform(0, 2 * Pi);
+    scene.gradientPeriods = uniform(0.5, 2);
+    scene.gradientSpeed   = uniform(-0.01, 0.01);
+    scene.flatLevel       = uniform(0.15, 0.85);
+    scene.chromaOffsetU   = uniform(-0.1, 0.1);
+    scene.chromaOffsetV   = uniform(-0.1, 0.1);
+    scene.noise           = uniform(0.001, 0.005);
+    return scene;
+}
+
+// Evaluates the sum of the waves of a texture. sin(a + b) is split into the parts that only
+// depend on x and on y so that only a few multiplications are needed per sample.
+class TextureRenderer
+{
+public:
+    TextureRenderer(const std::vector<Wave> &waves,
+                    unsigned frameIndex,
+                    unsigned width,
+                    unsigned shiftX)
+        : waves(waves)
+    {
+        this->sinX.resize(waves.size() * width);
+        this->cosX.resize(waves.size() * width);
+        this->sinY.resize(waves.size());
+        this->cosY.resize(waves.size());
+        this->width = width;
+
+        for (size_t i = 0; i < waves.size(); i++)
+        {
+            const auto &wave = waves[i];
+            for (unsigned x = 0; x < width; x++)
+            {
+                const auto lumaX = double(x << shiftX) + wave.motionX * frameIndex;
+                const auto angle = wave.frequencyX * lumaX + wave.phase;
+                this->sinX[i * width + x] = std::sin(angle);
+                this->cosX[i * width + x] = std::cos(angle);
+            }
+        }
+    }
+
+    void setRow(unsigned lumaY, unsigned frameIndex)
+    {
+        for (size_t i = 0; i < this->waves.size(); i++)
+        {
+            const auto &wave = this->waves[i];
+            const auto angle = wave.frequencyY * (lumaY + wave.motionY * frameIndex);
+            this->sinY[i]    = std::sin(angle);
+            this->cosY[i]    = std::cos(angle);
+        }
+    }
+
+    double get(unsigned x) const
+    {
+        double value = 0.5;
+        for (size_t i = 0; i < this->waves.size(); i++)
+        {
+            const auto index = i * this->width + x;
+            value += this->waves[i].amplitude
+                     * (this->sinX[index] * this->cosY[i] + this->cosX[index] * this->sinY[i]);
+        }
+        return value;
+    }
+
+private:
+    const std::vector<Wave> &waves;
+    unsigned width{};
+    std::vector<double> sinX;
+    std::vector<double> cosX;
+    std::vector<double> sinY;
+    std::vector<double> cosY;
+};
+
+template<typename SampleType>
+void writeRow(SampleType *row, const std::vector<double> &values, unsigned bitDepth)
+{
+    const auto maxValue = double((1u << bitDepth) - 1);
+    for (size_t x = 0; x < values.size(); x++)
+        row[x] = SampleType(std::lround(std::clamp(values[x], 0.0, 1.0) * maxValue));
+}
+
+void generateRandomFrame(FrameWithData &frame, std::default_random_engine &randomEngine)
+{
+    const auto bitDepth = frame.getFrame()->info.bitDepth;
+    std::uniform_int_distribution<unsigned> uniform_dist(0, (1u << bitDepth) - 1);
+
+    auto dataSize = frame.getFrameSize();
+    auto data     = frame.getData();
+    if (bitDepth > 8)
+    {
+        auto samples = (uint16_t *) (data);
+        for (size_t i = 0; i < dataSize / 2; i++)
+            samples[i] = uint16_t(uniform_dist(randomEngine));
+    }
+    else
+    {
+        for (size_t i = 0; i < dataSize; i++)
+            data[i] = uint8_t(uniform_dist(randomEngine));
+    }
+}
+
+void generateSyntheticFrame(FrameWithData &frame,
+                            unsigned frameIndex,
+                            const ContentParam &param,
+                            std::default_random_engine &randomEngine)
+{
+    auto vcaFrame        = frame.getFrame();
+    const auto &info     = vcaFrame->info;
+    const auto &csp      = vca_cli_csps.at(info.colorspace);
+    const auto sceneIdx  = param.sceneLength > 0 ? frameIndex / param.sceneLength : 0;
+    const auto sceneTime = param.sceneLength > 0 ? frameIndex % param.sceneLength : frameIndex;
+    const auto scene     = createScene(param.seed, sceneIdx);
+
+    std::uniform_real_distribution<double> noise(-scene.noise, scene.noise);
+
+    const auto gradientDirX = std::cos(scene.gradientAngle) * scene.gradientPeriods / info.width;
+    const auto gradientDirY = std::sin(scene.gradientAngle) * scene.gradientPeriods / info.height;
+    auto gradient           = [&](unsigned lumaX, unsigned lumaY) {
+        const auto u = lumaX * gradientDirX + lumaY * gradientDirY
+                       + scene.gradientSpeed * sceneTime;
+        // Triangle wave so that the gradient has no hard edges
+        return 0.1 + 0.8 * std::abs(2 * (u - std::floor(u)) - 1);
+    };
+
+    for (int plane = 0; plane < csp.planes; plane++)
+    {
+        const auto shiftX = unsigned(csp.width[plane]);
+        const auto shiftY = unsigned(csp.height[plane]);
+        const auto width  = info.width >> shiftX;
+        const auto height = info.height >> shiftY;
+
+        TextureRenderer textureA(scene.textureA, sceneTime, width, shiftX);
+        TextureRenderer textureB(scene.textureB, sceneTime, width, shiftX);
+
+        std::vector<double> values(width);
+        for (unsigned y = 0; y < height; y++)
+        {
+            const auto lumaY = y << shiftY;
+            textureA.setRow(lumaY, sceneTime);
+            textureB.setRow(lumaY, sceneTime);
+
+            for (unsigned x = 0; x < width; x++)
+            {
+                const auto lumaX = x << shiftX;
+
+                double value{};
+                switch (param.type)
+                {
+                    case ContentType::Flat:
+                        value = scene.flatLevel;
+                        break;
+                    case ContentType::Gradient:
+                        value = gradient(lumaX, lumaY);
+                        break;
+                    case ContentType::Texture:
+                        value = textureA.get(x);
+                        break;
+                    default:
+                        if (lumaY < info.height / 3)
+                            value = gradient(lumaX, lumaY);
+                        else if (lumaY < info.height * 2 / 3)
+                            value = textureA.get(x);
+                        else if (lumaX < info.width / 2)
+                            value = scene.flatLevel;
+                        else
+                            value = textureB.get(x);
+                        break;
+                }
+
+                // The chroma planes have much less detail than the luma plane
+                if (plane > 0)
+                    value = 0.5 + (plane == 1 ? scene.chromaOffsetU : scene.chromaOffsetV)
+                            + 0.25 * (value - 0.5);
+
+                values[x] = value + noise(randomEngine);
+            }
+
+            const auto row = vcaFrame->planes[plane] + size_t(y) * vcaFrame->stride[plane];
+            if (info.bitDepth > 8)
+                writeRow((uint16_t *) (row), values, info.bitDepth);
+            else
+                writeRow(row, values, info.bitDepth);
+        }
+    }
+}
+
+} // namespace
+
+std::optional<ContentType> parseContentType(const std::string &name)
+{
+    for (const auto &contentType : contentTypeNames)
+        if (contentType.second == name)
+            return contentType.first;
+    return {};
+}
+
+std::vector<std::unique_ptr<FrameWithData>> generateFrames(const vca_frame_info &frameInfo,
+                                                           unsigned nrFrames,
+                                                           const ContentParam &param)
+{
+    std::default_random_engine randomEngine(param.seed);
+
+    std::vector<std::unique_ptr<FrameWithData>> frames;
+    for (unsigned i = 0; i < nrFrames; i++)
+    {
+        auto newFrame = std::make_unique<FrameWithData>(frameInfo);
+        if (param.type == ContentType::Random)
+            generateRandomFrame(*newFrame, randomEngine);
+        else
+            generateSyntheticFrame(*newFrame, i, param, randomEngine);
+        frames.push_back(std::move(newFrame));
+    }
+    return frames;
+}
+
+} // namespace vca
@@ -0,0 +1,65 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <common/common.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace vca {
+
+// Synthetic content for the performance test. Uniform noise makes every DCT coefficient large,
+// which is not what the analyzer sees for real video. The other models produce content with
+// mostly small coefficients and with motion between the frames.
+enum class ContentType
+{
+    Random,   // Uniform noise in all samples
+    Flat,     // A constant level with a little noise
+    Gradient, // A moving linear gradient
+    Texture,  // A moving texture made of a few sine waves
+    Mixed     // Gradient on top, moving textures in the middle and flat regions at the bottom
+};
+
+const std::map<ContentType, std::string> contentTypeNames = {{ContentType::Random, "random"},
+                                                             {ContentType::Flat, "flat"},
+                                                             {ContentType::Gradient, "gradient"},
+                                                             {ContentType::Texture, "texture"},
+                                                             {ContentType::Mixed, "mixed"}};
+
+std::optional<ContentType> parseContentType(const std::string &name);
+
+struct ContentParam
+{
+    ContentType type{ContentType::Mixed};
+    // Every this many frames there is a scene cut and the content changes completely.
+    // 0 means no scene cuts. Not used for random content.
+    unsigned sceneLength{30};
+    unsigned seed{};
+};
+
+std::vector<std::unique_ptr<FrameWithData>> generateFrames(const vca_frame_info &frameInfo,
+                                                           unsigned nrFrames,
+                                                           const ContentParam &param);
+
+} // namespace vca
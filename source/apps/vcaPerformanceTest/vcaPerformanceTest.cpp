@@ -17,17 +17,28 @@
  * along with this program.
  *****************************************************************************/
 
+#include "ContentGenerator.h"
 #include "vcacli.h"
 
 #include <common/input/Y4MInput.h>
 #include <common/input/YUVInput.h>
 #include <common/stats/YUViewStatsFile.h>
+#include <lib/analyzer/LockFreeQueue.h>
+#include <lib/analyzer/MultiThreadQueue.h>
+#include <lib/analyzer/common.h>
 #include <lib/vcaLib.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <optional>
 #include <random>
 #include <signal.h>
+#include <stdexcept>
+#include <sstream>
 #include <thread>
 #include <queue>
 
@@ -111,12 +122,91 @@ void printStatus(uint32_t frameNum,
     fflush(stdout); // needed in windows
 }
 
+struct Resolution
+{
+    std::string name;
+    unsigned width{};
+    unsigned height{};
+};
+
+const std::vector<Resolution> namedResolutions = {{"540p", 960, 540},
+                                                  {"720p", 1280, 720},
+                                                  {"1080p", 1920, 1080},
+                                                  {"1440p", 2560, 1440},
+                                                  {"2160p", 3840, 2160},
+                                                  {"4320p", 7680, 4320}};
+
+const std::map<vca_colorSpace, std::string> colorspaceNames = {{vca_colorSpace::YUV400, "400"},
+                                                               {vca_colorSpace::YUV420, "420"},
+                                                               {vca_colorSpace::YUV422, "422"},
+                                                               {vca_colorSpace::YUV444, "444"}};
+
 struct CLIOptions
 {
     unsigned nrFrames{1000};
     vca_param vcaParam;
+
+    bool sweep{false};
+    std::vector<Resolution> sweepResolutions{namedResolutions};
+    std::vector<unsigned> sweepBitDepths{8, 10, 12};
+    std::vector<vca_colorSpace> sweepColorspaces{vca_colorSpace::YUV400,
+                                                 vca_colorSpace::YUV420,
+                                                 vca_colorSpace::YUV422,
+                                                 vca_colorSpace::YUV444};
+    std::string sweepFilename;
+
+    ContentParam content;
+    // How many different frames are held in memory and pushed in a loop. 0 means automatic.
+    unsigned framesInMemory{0};
+
+    // Replay the frames of this file instead of generating content
+    std::string inputFilename;
+    bool openAsY4m{};
 };
 
+// Limit the memory for the test frames. A 4320p 4:4:4 frame with 12 bit takes ~190 MiB.
+constexpr size_t MaxFrameMemory = size_t(2) << 30;
+
+std::vector<std::string> splitList(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+std::optional<Resolution> parseResolution(const std::string &arg)
+{
+    for (const auto &resolution : namedResolutions)
+        if (resolution.name == arg)
+            return resolution;
+
+    auto posX = arg.find("x");
+    if (posX == std::string::npos)
+        return {};
+    Resolution resolution;
+    resolution.name   = arg;
+    resolution.width  = std::stoul(arg.substr(0, posX));
+    resolution.height = std::stoul(arg.substr(posX + 1));
+    return resolution;
+}
+
+std::optional<vca_colorSpace> parseColorspace(const std::string &arg)
+{
+    if (arg == "400" || arg == "4:0:0")
+        return vca_colorSpace::YUV400;
+    if (arg == "420" || arg == "4:2:0")
+        return vca_colorSpace::YUV420;
+    if (arg == "422" || arg == "4:2:2")
+        return vca_colorSpace::YUV422;
+    if (arg == "444" || arg == "4:4:4")
+        return vca_colorSpace::YUV444;
+    return {};
+}
+
 std::optional<CLIOptions> parseCLIOptions(int argc, char **argv)
 {
     bool bError = false;
@@ -163,40 +253,115 @@ std::optional<CLIOptions> parseCLIOptions(int argc, char **argv)
         }
 
         auto name = std::string(long_options[long_options_index].name);
-        auto arg  = std::string(optarg);
+        auto arg  = std::string(optarg ? optarg : "");
         if (name == "iterations")
             options.nrFrames = std::stoul(optarg);
         else if (name == "input-depth")
             options.vcaParam.frameInfo.bitDepth = std::stoul(optarg);
         else if (name == "input-res")
         {
-            auto posX = arg.find("x");
-            if (posX == std::string::npos)
+            auto resolution = parseResolution(arg);
+            if (!resolution)
             {
                 vca_log(LogLevel::Error, "Invalid resolution provided. Format WxH.");
                 return {};
             }
-            options.vcaParam.frameInfo.width  = std::stoul(arg.substr(0, posX));
-            options.vcaParam.frameInfo.height = std::stoul(arg.substr(posX + 1));
+            options.vcaParam.frameInfo.width  = resolution->width;
+            options.vcaParam.frameInfo.height = resolution->height;
         }
         else if (name == "input-csp")
         {
-            if (arg == "400" || arg == "4:0:0")
-                options.vcaParam.frameInfo.colorspace = vca_colorSpace::YUV400;
-            else if (arg == "420" || arg == "4:2:0")
-                options.vcaParam.frameInfo.colorspace = vca_colorSpace::YUV420;
-            else if (arg == "422" || arg == "4:2:2")
-                options.vcaParam.frameInfo.colorspace = vca_colorSpace::YUV422;
-            else if (arg == "444" || arg == "4:4:4")
-                options.vcaParam.frameInfo.colorspace = vca_colorSpace::YUV444;
+            if (auto colorspace = parseColorspace(arg))
+                options.vcaParam.frameInfo.colorspace = *colorspace;
+        }
+        else if (name == "threads")
+            options.vcaParam.nrFrameThreads = std::stoul(optarg);
+        else if (name == "sweep")
+            options.sweep = true;
+        else if (name == "sweep-res")
+        {
+            options.sweepResolutions.clear();
+            for (const auto &item : splitList(arg))
+            {
+                auto resolution = parseResolution(item);
+                if (!resolution)
+                {
+                    vca_log(LogLevel::Error, "Invalid sweep resolution " + item);
+                    return {};
+                }
+                options.sweepResolutions.push_back(*resolution);
+            }
+        }
+        else if (name == "sweep-depth")
+        {
+            options.sweepBitDepths.clear();
+            for (const auto &item : splitList(arg))
+                options.sweepBitDepths.push_back(std::stoul(item));
         }
+        else if (name == "sweep-csp")
+        {
+            options.sweepColorspaces.clear();
+            for (const auto &item : splitList(arg))
+            {
+                auto colorspace = parseColorspace(item);
+                if (!colorspace)
+                {
+                    vca_log(LogLevel::Error, "Invalid sweep chroma format " + item);
+                    return {};
+                }
+                options.sweepColorspaces.push_back(*colorspace);
+            }
+        }
+        else if (name == "sweep-output")
+            options.sweepFilename = optarg;
+        else if (name == "content")
+        {
+            auto contentType = parseContentType(arg);
+            if (!contentType)
+            {
+                vca_log(LogLevel::Error, "Invalid content type " + arg);
+                return {};
+            }
+            options.content.type = *contentType;
+        }
+        else if (name == "scene-length")
+            options.content.sceneLength = std::stoul(optarg);
+        else if (name == "frames-in-memory")
+            options.framesInMemory = std::stoul(optarg);
+        else if (name == "input")
+            options.inputFilename = optarg;
+        else if (name == "y4m")
+            options.openAsY4m = true;
+
+        long_options_index = -1;
     }
 
+    if (options.inputFilename.size() >= 4
+        && options.inputFilename.substr(options.inputFilename.size() - 4) == ".y4m")
+        options.openAsY4m = true;
+
     return options;
 }
 
 bool checkOptions(CLIOptions options)
 {
+    if (options.sweep)
+    {
+        if (options.sweepResolutions.empty() || options.sweepBitDepths.empty()
+            || options.sweepColorspaces.empty())
+        {
+            vca_log(LogLevel::Error, "The sweep lists must not be empty");
+            return false;
+        }
+        for (auto bitDepth : options.sweepBitDepths)
+        {
+            if (bitDepth < 8 || bitDepth > 12)
+            {
+                vca_log(LogLevel::Error, "Invalid sweep bit depth " + std::to_string(bitDepth));
+                return false;
+            }
+        }
+    }
     return true;
 }
 
@@ -204,29 +369,169 @@ void logOptions(CLIOptions options)
 {
     vca_log(LogLevel::Info, "Options:   "s);
     vca_log(LogLevel::Info, "  Number frames:     "s + std::to_string(options.nrFrames));
+    if (!options.inputFilename.empty())
+        vca_log(LogLevel::Info, "  Replay input file: "s + options.inputFilename);
+    else
+    {
+        vca_log(LogLevel::Info,
+                "  Content:           "s + contentTypeNames.at(options.content.type));
+        vca_log(LogLevel::Info,
+                "  Scene length:      "s + std::to_string(options.content.sceneLength));
+    }
+    if (options.sweep)
+    {
+        std::string resolutions;
+        for (const auto &resolution : options.sweepResolutions)
+            resolutions += " " + resolution.name;
+        std::string bitDepths;
+        for (auto bitDepth : options.sweepBitDepths)
+            bitDepths += " " + std::to_string(bitDepth);
+        std::string colorspaces;
+        for (auto colorspace : options.sweepColorspaces)
+            colorspaces += " " + colorspaceNames.at(colorspace);
+        vca_log(LogLevel::Info, "  Sweep resolutions:"s + resolutions);
+        vca_log(LogLevel::Info, "  Sweep bit depths: "s + bitDepths);
+        vca_log(LogLevel::Info, "  Sweep chroma:     "s + colorspaces);
+    }
 }
 
-std::vector<std::unique_ptr<FrameWithData>> generateRandomFrames(vca_frame_info frameInfo,
-                                                                 unsigned nrFrames)
+unsigned getNrFramesToAllocate(const CLIOptions &options,
+                               const vca_frame_info &frameInfo,
+                               unsigned nrThreads)
 {
-    if (frameInfo.colorspace != vca_colorSpace::YUV420 || frameInfo.bitDepth != 8)
-        throw std::exception("Not implemented yet");
+    auto nrFrames = options.framesInMemory;
+    if (nrFrames == 0)
+    {
+        // Enough frames so that each thread works on a different one. For synthetic content
+        // also enough to contain a scene cut.
+        nrFrames = nrThreads + 1;
+        if (options.content.type != ContentType::Random)
+            nrFrames = std::max(nrFrames, options.content.sceneLength * 2);
+    }
 
-    std::random_device randomDevice;
-    std::default_random_engine randomEngine(randomDevice());
-    std::uniform_int_distribution<unsigned> uniform_dist(0, 255);
+    const auto frameSize    = FrameWithData(frameInfo).getFrameSize();
+    const auto memoryFrames = unsigned(std::max(MaxFrameMemory / frameSize, size_t(1)));
+    return std::clamp(nrFrames, 1u, memoryFrames);
+}
+
+std::vector<std::unique_ptr<FrameWithData>> createTestFrames(const CLIOptions &options,
+                                                             const vca_frame_info &frameInfo,
+                                                             unsigned nrThreads)
+{
+    const auto nrFrames = getNrFramesToAllocate(options, frameInfo, nrThreads);
+    auto frames         = generateFrames(frameInfo, nrFrames, options.content);
+    vca_log(LogLevel::Info,
+            "Generated " + std::to_string(frames.size()) + " "
+                + contentTypeNames.at(options.content.type) + " frames");
+    return frames;
+}
+
+// Read the frames of the input file into memory so that reading does not influence the
+// measurement. Reads all frames that fit into the memory limit or framesInMemory frames.
+std::optional<std::vector<std::unique_ptr<FrameWithData>>> loadInputFrames(
+    const CLIOptions &options, double &fps)
+{
+    auto inputFilename = options.inputFilename;
+    auto frameInfo     = options.vcaParam.frameInfo;
+
+    std::unique_ptr<IInputFile> inputFile;
+    if (options.openAsY4m)
+        inputFile = std::make_unique<Y4MInput>(inputFilename, 0, false);
+    else
+        inputFile = std::make_unique<YUVInput>(inputFilename, frameInfo, 0, false);
+    if (inputFile->isFail())
+    {
+        vca_log(LogLevel::Error, "Error opening input file " + inputFilename);
+        return {};
+    }
+
+    frameInfo     = inputFile->getFrameInfo();
+    auto nrFrames = unsigned(std::max(MaxFrameMemory / FrameWithData(frameInfo).getFrameSize(),
+                                      size_t(1)));
+    if (options.framesInMemory > 0)
+        nrFrames = std::min(nrFrames, options.framesInMemory);
 
     std::vector<std::unique_ptr<FrameWithData>> frames;
-    for (unsigned i = 0; i < nrFrames; i++)
+    while (frames.size() < nrFrames)
+    {
+        auto frame = std::make_unique<FrameWithData>(frameInfo);
+        if (!inputFile->readFrame(*frame))
+            break;
+        frames.push_back(std::move(frame));
+    }
+
+    if (frames.empty())
     {
-        auto newFrame = std::make_unique<FrameWithData>(frameInfo);
-        auto dataSize = newFrame->getFrameSize();
-        auto data     = newFrame->getData();
-        for (size_t i = 0; i < dataSize; i++)
-            data[i] = uint8_t(uniform_dist(randomEngine));
-        frames.push_back(std::move(newFrame));
+        vca_log(LogLevel::Error, "No frames could be read from " + inputFilename);
+        return {};
     }
-    return std::move(frames);
+
+    fps = inputFile->getFPS();
+    vca_log(LogLevel::Info,
+            "Read " + std::to_string(frames.size()) + " frames of "
+                + std::to_string(frameInfo.width) + "x" + std::to_string(frameInfo.height)
+                + " from " + inputFilename);
+    return frames;
+}
+
+// Pass jobs through the queues the same way the analyzer does. One thread pushes the jobs,
+// the workers pop them and push the results and the main thread pops the results.
+template<template<class> class Queue>
+void runQueueTest(unsigned nrThreads, unsigned nrJobs)
+{
+    Queue<Job> jobs;
+    Queue<std::shared_ptr<SharedResult>> results;
+    jobs.setMaximumQueueSize(5);
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < nrThreads; i++)
+        workers.emplace_back([&jobs, &results]() {
+            while (auto job = jobs.waitAndPop())
+            {
+                auto result          = std::make_shared<SharedResult>();
+                result->result.jobID = job->jobID;
+                results.waitAndPush(std::move(result));
+            }
+        });
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([&jobs, nrJobs]() {
+        for (unsigned i = 0; i < nrJobs; i++)
+        {
+            Job job{};
+            job.jobID = i;
+            jobs.waitAndPush(job);
+        }
+    });
+
+    std::vector<bool> received(nrJobs);
+    for (unsigned i = 0; i < nrJobs; i++)
+    {
+        if (auto result = results.waitAndPop())
+            received[(*result)->result.jobID] = true;
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - startTime);
+
+    producer.join();
+    jobs.abort();
+    results.abort();
+    for (auto &worker : workers)
+        worker.join();
+
+    auto missing = std::count(received.begin(), received.end(), false);
+    if (missing > 0)
+        vca_log(LogLevel::Error, "Queue test lost " + std::to_string(missing) + " results");
+
+    auto jobsPerSecond = duration.count() > 0 ? nrJobs * 1000000. / duration.count() : 0;
+    fprintf(stdout,
+            "vca - Passed %d jobs through %d threads, %.0f jobs/s, time %.3f ms\n",
+            nrJobs,
+            nrThreads,
+            jobsPerSecond,
+            duration.count() / 1000.);
 }
 
 #ifdef _WIN32
@@ -269,18 +574,60 @@ static int get_argv_utf8(int *argc_ptr, char ***argv_ptr)
 }
 #endif
 
-void runTest(CLIOptions &options, std::vector<std::unique_ptr<FrameWithData>> &pushFrames)
+struct TestResult
+{
+    unsigned nrFrames{};
+    double seconds{};
+    // The time from pushing a frame until its result was pulled in milliseconds
+    std::vector<double> latenciesMs;
+    // The epsilon of each frame for the shot detection
+    std::vector<double> epsilons;
+};
+
+std::optional<TestResult> runTest(CLIOptions &options,
+                                  std::vector<std::unique_ptr<FrameWithData>> &pushFrames,
+                                  bool printProgress = true)
 {
     auto analyzer = vca_analyzer_open(options.vcaParam);
     if (analyzer == nullptr)
     {
         vca_log(LogLevel::Error, "Error opening analyzer");
-        return;
+        return {};
     }
 
-    printStatus(0, options.nrFrames, true);
+    if (printProgress)
+        printStatus(0, options.nrFrames, true);
 
-    using framePtr          = std::unique_ptr<FrameWithData>;
+    using clock = std::chrono::steady_clock;
+    std::vector<clock::time_point> pushTimes(options.nrFrames);
+
+    TestResult testResult;
+    testResult.latenciesMs.reserve(options.nrFrames);
+    testResult.epsilons.resize(options.nrFrames);
+
+    auto pullResult = [&]() {
+        vca_frame_results result;
+
+        vca_log(LogLevel::Debug, "Result available. Pulling it");
+
+        if (vca_analyzer_pull_frame_result(analyzer, &result) == VCA_ERROR)
+        {
+            vca_log(LogLevel::Error, "Error pulling frame result");
+            return false;
+        }
+
+        auto latency = clock::now() - pushTimes.at(result.poc);
+        testResult.latenciesMs.push_back(
+            std::chrono::duration<double, std::milli>(latency).count());
+        testResult.epsilons.at(result.poc) = result.epsilon;
+
+        vca_log(LogLevel::Debug,
+                "Got results POC " + std::to_string(result.poc) + " averageEnergy "
+                    + std::to_string(result.averageEnergy) + " sad " + std::to_string(result.sad));
+        return true;
+    };
+
+    const auto startTime    = clock::now();
     auto frameIt            = pushFrames.begin();
     unsigned pushedFrames   = 0;
     unsigned resultsCounter = 0;
@@ -292,36 +639,25 @@ void runTest(CLIOptions &options, std::vector<std::unique_ptr<FrameWithData>> &p
         vca_log(LogLevel::Debug,
                 "Start push frame " + std::to_string(pushedFrames) + " to analyzer");
 
-        auto ret = vca_analyzer_push(analyzer, vcaFrame);
+        pushTimes[pushedFrames] = clock::now();
+        auto ret                = vca_analyzer_push(analyzer, vcaFrame);
         if (ret == VCA_ERROR)
         {
             vca_log(LogLevel::Error, "Error pushing frame to lib");
-            return;
+            return {};
         }
 
         vca_log(LogLevel::Debug, "Pushed frame " + std::to_string(pushedFrames) + " to analyzer");
 
         while (vca_result_available(analyzer))
         {
-            vca_frame_results result;
-
-            vca_log(LogLevel::Debug, "Result available. Pulling it");
-
-            if (vca_analyzer_pull_frame_result(analyzer, &result) == VCA_ERROR)
-            {
-                vca_log(LogLevel::Error, "Error pulling frame result");
-                return;
-            }
-
-            vca_log(LogLevel::Debug,
-                    "Got results POC " + std::to_string(result.poc) + " averageEnergy "
-                        + std::to_string(result.averageEnergy) + " sad "
-                        + std::to_string(result.sad));
-
+            if (!pullResult())
+                return {};
             resultsCounter++;
         }
 
-        printStatus(resultsCounter, options.nrFrames);
+        if (printProgress)
+            printStatus(resultsCounter, options.nrFrames);
 
         frameIt++;
         if (frameIt == pushFrames.end())
@@ -330,25 +666,189 @@ void runTest(CLIOptions &options, std::vector<std::unique_ptr<FrameWithData>> &p
 
     while (resultsCounter < pushedFrames)
     {
-        vca_frame_results result;
+        if (!pullResult())
+            return {};
+        resultsCounter++;
+    }
 
-        vca_log(LogLevel::Debug, "Result available. Pulling it");
+    testResult.nrFrames = resultsCounter;
+    testResult.seconds  = std::chrono::duration<double>(clock::now() - startTime).count();
 
-        if (vca_analyzer_pull_frame_result(analyzer, &result) == VCA_ERROR)
+    vca_analyzer_close(analyzer);
+    if (printProgress)
+        printStatus(options.nrFrames, options.nrFrames, false, true);
+    return testResult;
+}
+
+// Run the shot detection on the epsilons of a test to see how it behaves for the content
+void logShotDetection(const TestResult &testResult, double fps)
+{
+    std::vector<vca_shot_detect_frame> frames(testResult.epsilons.size());
+    for (size_t i = 0; i < frames.size(); i++)
+        frames[i].epsilon = testResult.epsilons[i];
+
+    vca_shot_detection_param param;
+    param.fps = fps;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    if (vca_shot_detection(param, frames.data(), frames.size()) == VCA_ERROR)
+    {
+        vca_log(LogLevel::Error, "Error running the shot detection");
+        return;
+    }
+    const auto duration = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime);
+
+    const auto nrShots = std::count_if(frames.begin(), frames.end(), [](const auto &frame) {
+        return frame.isNewShot;
+    });
+    fprintf(stdout,
+            "vca - Shot detection found %d shots in %d frames, time %.3f ms\n",
+            int(nrShots),
+            int(frames.size()),
+            duration.count());
+}
+
+struct SweepResult
+{
+    vca_frame_info frameInfo;
+    unsigned nrThreads{};
+    unsigned nrFrames{};
+    double fps{};
+    double fpsPerThread{};
+    // The fps per thread relative to the fps per thread of the lowest thread count of the same
+    // frame format. 1.0 means perfect scaling.
+    double efficiency{};
+    double latencyP50Ms{};
+    double latencyP90Ms{};
+    double latencyP99Ms{};
+    double latencyMaxMs{};
+};
+
+double percentile(const std::vector<double> &sortedValues, double p)
+{
+    if (sortedValues.empty())
+        return 0;
+    auto rank = size_t(std::ceil(p * sortedValues.size()));
+    return sortedValues[std::clamp(rank, size_t(1), sortedValues.size()) - 1];
+}
+
+// 1, 2, 4, ... up to and including maxThreads
+std::vector<unsigned> getSweepThreadCounts(unsigned maxThreads)
+{
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+    return threadCounts;
+}
+
+void writeSweepTable(std::ostream &out, const std::vector<SweepResult> &results)
+{
+    out << "threads,width,height,bitDepth,chroma,frames,fps,fpsPerThread,efficiency,"
+           "latencyP50Ms,latencyP90Ms,latencyP99Ms,latencyMaxMs\n";
+    out << std::fixed << std::setprecision(3);
+    for (const auto &result : results)
+        out << result.nrThreads << "," << result.frameInfo.width << ","
+            << result.frameInfo.height << "," << result.frameInfo.bitDepth << ","
+            << colorspaceNames.at(result.frameInfo.colorspace) << "," << result.nrFrames << ","
+            << result.fps << "," << result.fpsPerThread << "," << result.efficiency << ","
+            << result.latencyP50Ms << "," << result.latencyP90Ms << "," << result.latencyP99Ms
+            << "," << result.latencyMaxMs << "\n";
+}
+
+bool runSweep(CLIOptions &options, std::vector<std::unique_ptr<FrameWithData>> &replayFrames)
+{
+    auto maxThreads = options.vcaParam.nrFrameThreads;
+    if (maxThreads == 0)
+        maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // When replaying a file, only the thread count is swept
+    std::vector<std::pair<std::string, vca_frame_info>> formats;
+    if (!replayFrames.empty())
+        formats.push_back({options.inputFilename, replayFrames.front()->getFrame()->info});
+    else
+    {
+        for (const auto &resolution : options.sweepResolutions)
         {
-            vca_log(LogLevel::Error, "Error pulling frame result");
-            return;
+            for (auto bitDepth : options.sweepBitDepths)
+            {
+                for (auto colorspace : options.sweepColorspaces)
+                {
+                    vca_frame_info frameInfo;
+                    frameInfo.width      = resolution.width;
+                    frameInfo.height     = resolution.height;
+                    frameInfo.bitDepth   = bitDepth;
+                    frameInfo.colorspace = colorspace;
+                    formats.push_back({resolution.name + " - " + std::to_string(bitDepth)
+                                           + " bit - " + colorspaceNames.at(colorspace),
+                                       frameInfo});
+                }
+            }
         }
+    }
 
-        vca_log(LogLevel::Debug,
-                "Got results POC " + std::to_string(result.poc) + " averageEnergy "
-                    + std::to_string(result.averageEnergy) + " sad " + std::to_string(result.sad));
+    std::vector<SweepResult> results;
+    for (const auto &format : formats)
+    {
+        const auto &frameInfo = format.second;
 
-        resultsCounter++;
+        std::vector<std::unique_ptr<FrameWithData>> generatedFrames;
+        if (replayFrames.empty())
+            generatedFrames = createTestFrames(options, frameInfo, maxThreads);
+        auto &pushFrames = replayFrames.empty() ? generatedFrames : replayFrames;
+
+        double baseFpsPerThread = 0;
+        for (auto threads : getSweepThreadCounts(maxThreads))
+        {
+            std::cout << "  [Sweep - " << format.first << " - " << threads << " threads]\n";
+
+            options.vcaParam.frameInfo      = frameInfo;
+            options.vcaParam.nrFrameThreads = threads;
+
+            auto testResult = runTest(options, pushFrames);
+            if (!testResult || b_ctrl_c)
+                return false;
+
+            auto &latencies = testResult->latenciesMs;
+            std::sort(latencies.begin(), latencies.end());
+
+            const auto fps = testResult->seconds > 0 ? testResult->nrFrames / testResult->seconds
+                                                     : 0;
+            if (baseFpsPerThread == 0)
+                baseFpsPerThread = fps / threads;
+
+            SweepResult result;
+            result.frameInfo    = frameInfo;
+            result.nrThreads    = threads;
+            result.nrFrames     = testResult->nrFrames;
+            result.fps          = fps;
+            result.fpsPerThread = fps / threads;
+            result.efficiency   = baseFpsPerThread > 0 ? result.fpsPerThread / baseFpsPerThread : 0;
+            result.latencyP50Ms = percentile(latencies, 0.5);
+            result.latencyP90Ms = percentile(latencies, 0.9);
+            result.latencyP99Ms = percentile(latencies, 0.99);
+            result.latencyMaxMs = latencies.empty() ? 0 : latencies.back();
+            results.push_back(result);
+        }
     }
 
-    vca_analyzer_close(analyzer);
-    printStatus(options.nrFrames, options.nrFrames, false, true);
+    if (options.sweepFilename.empty() || options.sweepFilename == "-")
+    {
+        std::cout << "\n";
+        writeSweepTable(std::cout, results);
+        return true;
+    }
+
+    std::ofstream file(options.sweepFilename);
+    if (!file.is_open())
+    {
+        vca_log(LogLevel::Error, "Error opening sweep output file " + options.sweepFilename);
+        return false;
+    }
+    writeSweepTable(file, results);
+    vca_log(LogLevel::Info, "Wrote sweep results to " + options.sweepFilename);
+    return true;
 }
 
 int main(int argc, char **argv)
@@ -390,18 +890,47 @@ int main(int argc, char **argv)
         vca_log(LogLevel::Error,
                 "Unable to register CTRL+C handler: " + std::string(strerror(errno)));
 
-    auto nrFramesToAllocate = options.vcaParam.nrFrameThreads;
-    if (nrFramesToAllocate == 0)
-        nrFramesToAllocate = std::thread::hardware_concurrency();
+    // Synthetic content is treated as 24 fps for the shot detection
+    double fps = 24;
+    std::vector<std::unique_ptr<FrameWithData>> replayFrames;
+    if (!options.inputFilename.empty())
+    {
+        auto inputFrames = loadInputFrames(options, fps);
+        if (!inputFrames)
+            return 1;
+        replayFrames               = std::move(*inputFrames);
+        options.vcaParam.frameInfo = replayFrames.front()->getFrame()->info;
+    }
+
+    if (options.sweep)
+        return runSweep(options, replayFrames) ? 0 : 1;
+
+    auto nrThreads = options.vcaParam.nrFrameThreads;
+    if (nrThreads == 0)
+        nrThreads = std::thread::hardware_concurrency();
+
+    std::vector<unsigned> queueTestThreads = {1};
+    if (nrThreads > 1)
+        queueTestThreads.push_back(nrThreads);
+    for (auto threads : queueTestThreads)
+    {
+        std::cout << "  [Queue test - MultiThreadQueue - " << threads << " threads]\n";
+        runQueueTest<MultiThreadQueue>(threads, options.nrFrames * 100);
+        std::cout << "  [Queue test - LockFreeQueue - " << threads << " threads]\n";
+        runQueueTest<LockFreeQueue>(threads, options.nrFrames * 100);
+    }
+    std::cout << "\n";
 
-    auto pushFrames = generateRandomFrames(options.vcaParam.frameInfo, nrFramesToAllocate + 1);
-    vca_log(LogLevel::Info, "Generated " + std::to_string(pushFrames.size()) + " random frames");
+    auto pushFrames = replayFrames.empty()
+                          ? createTestFrames(options, options.vcaParam.frameInfo, nrThreads)
+                          : std::move(replayFrames);
 
     const std::map<CpuSimd, std::string> cpuSimdNames = {{CpuSimd::None, "None"},
                                                          {CpuSimd::SSE2, "SSE2"},
                                                          {CpuSimd::SSSE3, "SSSE3"},
                                                          {CpuSimd::SSE4, "SSE4"},
-                                                         {CpuSimd::AVX2, "AVX2"}};
+                                                         {CpuSimd::AVX2, "AVX2"},
+                                                         {CpuSimd::AVX512, "AVX512"}};
 
     for (auto &simd : cpuSimdNames)
     {
@@ -412,7 +941,8 @@ int main(int argc, char **argv)
             options.vcaParam.cpuSimd   = simd.first;
             options.vcaParam.blockSize = blocksize;
 
-            runTest(options, pushFrames);
+            if (auto testResult = runTest(options, pushFrames))
+                logShotDetection(*testResult, fps);
             std::cout << "\n";
         }
     }
@@ -24,18 +24,23 @@
 
 #include <stdio.h>
 
-static const char short_options[]         = "f:h?";
+static const char short_options[]         = "N:h?";
 static const struct option long_options[] = {{"help", no_argument, NULL, 'h'},
                                              {"iterations", required_argument, NULL, 'N'},
                                              {"input-res", required_argument, NULL, 0},
                                              {"input-depth", required_argument, NULL, 0},
                                              {"input-csp", required_argument, NULL, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
-                                             {0, 0, 0, 0},
+                                             {"threads", required_argument, NULL, 0},
+                                             {"sweep", no_argument, NULL, 0},
+                                             {"sweep-res", required_argument, NULL, 0},
+                                             {"sweep-depth", required_argument, NULL, 0},
+                                             {"sweep-csp", required_argument, NULL, 0},
+                                             {"sweep-output", required_argument, NULL, 0},
+                                             {"content", required_argument, NULL, 0},
+                                             {"scene-length", required_argument, NULL, 0},
+                                             {"frames-in-memory", required_argument, NULL, 0},
+                                             {"input", required_argument, NULL, 0},
+                                             {"y4m", no_argument, NULL, 0},
                                              {0, 0, 0, 0}};
 
 static void showHelp()
@@ -54,4 +59,41 @@ static void showHelp()
     printf("                                 420 (4:2:0 default)\n");
     printf("                                 422 (4:2:2)\n");
     printf("                                 444 (4:4:4)\n");
+    printf("   --threads <integer>           Nr of threads to use. In the sweep the maximum number "
+           "of\n");
+    printf("                                 threads. (Default: 0 (autodetect))\n");
+    printf("\nContent Options:\n");
+    printf("   --content <string>            Synthetic content of the test frames\n");
+    printf("                                 random (uniform noise)\n");
+    printf("                                 flat (constant level with little noise)\n");
+    printf("                                 gradient (moving gradient)\n");
+    printf("                                 texture (moving texture)\n");
+    printf("                                 mixed (all of the above in regions, default)\n");
+    printf("   --scene-length <integer>      Frames between scene cuts of the synthetic content. 0 "
+           "for\n");
+    printf("                                 no scene cuts. (Default 30)\n");
+    printf("   --frames-in-memory <integer>  Nr of different frames that are pushed in a loop. "
+           "(Default:\n");
+    printf("                                 threads + 1, at least 2 scenes for synthetic "
+           "content)\n");
+    printf("   --input <filename>            Replay the frames of this YUV or Y4M file from memory "
+           "instead\n");
+    printf("                                 of synthetic content. As many frames as fit into 2 "
+           "GiB are read.\n");
+    printf("                                 For YUV files set --input-res, --input-depth and "
+           "--input-csp.\n");
+    printf("   --y4m                         Parse the input as Y4M. Automatic for .y4m files\n");
+    printf("\nSweep Options:\n");
+    printf("   --sweep                       Measure all combinations of 1, 2, 4, .. threads and "
+           "the\n");
+    printf("                                 sweep resolutions, bit depths and chroma formats\n");
+    printf("   --sweep-res <list>            Comma separated resolutions. WxH or one of 540p, "
+           "720p,\n");
+    printf("                                 1080p, 1440p, 2160p, 4320p. (Default: all of "
+           "these)\n");
+    printf("   --sweep-depth <list>          Comma separated bit depths. (Default: 8,10,12)\n");
+    printf("   --sweep-csp <list>            Comma separated chroma formats. (Default: "
+           "400,420,422,444)\n");
+    printf("   --sweep-output <filename>     Write the CSV table of the sweep to this file. "
+           "(Default: stdout)\n");
 }
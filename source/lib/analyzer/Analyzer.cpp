@@ -20,6 +20,7 @@
 #include "EnergyCalculation.h"
 #include "simd/cpu.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 
@@ -29,13 +30,15 @@ const std::map<CpuSimd, std::string> cpuSimdNames = {{CpuSimd::None, "None"},
                                                      {CpuSimd::SSE2, "SSE2"},
                                                      {CpuSimd::SSSE3, "SSSE3"},
                                                      {CpuSimd::SSE4, "SSE4"},
-                                                     {CpuSimd::AVX2, "AVX2"}};
+                                                     {CpuSimd::AVX2, "AVX2"},
+                                                     {CpuSimd::AVX512, "AVX512"}};
 
 const std::map<CpuSimd, unsigned> cpuSimdLevel = {{CpuSimd::None, 0},
                                                   {CpuSimd::SSE2, 1},
                                                   {CpuSimd::SSSE3, 2},
                                                   {CpuSimd::SSE4, 3},
-                                                  {CpuSimd::AVX2, 4}};
+                                                  {CpuSimd::AVX2, 4},
+                                                  {CpuSimd::AVX512, 5}};
 
 } // namespace
 
@@ -43,10 +46,15 @@ namespace vca {
 
 Analyzer::Analyzer(vca_param cfg)
 {
-    this->cfg = cfg;
-    this->jobs.setMaximumQueueSize(5);
+    this->cfg        = cfg;
+    this->resultPool = std::make_shared<ResultPool>();
+    this->jobs.setMaximumQueueSize(5 * std::max(cfg.nrSliceThreads, 1u));
 
     log(cfg, LogLevel::Info, "Block size: " + std::to_string(this->cfg.blockSize));
+    if (cfg.nrSliceThreads > 1)
+        log(cfg,
+            LogLevel::Info,
+            "Splitting frames into " + std::to_string(cfg.nrSliceThreads) + " slices");
 
     if (this->cfg.cpuSimd == CpuSimd::Autodetect)
     {
@@ -66,6 +74,7 @@ Analyzer::Analyzer(vca_param cfg)
         }
     }
     log(cfg, LogLevel::Info, "Using SIMD " + cpuSimdNames.at(this->cfg.cpuSimd));
+    setupEnergyPrimitives(this->primitives, this->cfg.cpuSimd);
 
     if (cfg.nrFrameThreads == 0)
     {
@@ -77,7 +86,11 @@ Analyzer::Analyzer(vca_param cfg)
     log(cfg, LogLevel::Info, "Starting " + std::to_string(nrThreads) + " threads");
     for (unsigned i = 0; i < nrThreads; i++)
     {
-        auto newThread = std::make_unique<ProcessingThread>(this->cfg, this->jobs, this->results, i);
+        auto newThread = std::make_unique<ProcessingThread>(this->cfg,
+                                                            this->primitives,
+                                                            this->jobs,
+                                                            this->results,
+                                                            i);
         this->threadPool.push_back(std::move(newThread));
     }
 }
@@ -97,54 +110,203 @@ vca_result Analyzer::pushFrame(vca_frame *frame)
     if (!this->checkFrame(frame))
         return vca_result::VCA_ERROR;
 
-    Job job;
-    job.frame = frame;
-    job.jobID = this->frameCounter;
-    // job.macroblockRange = TODO
+    auto [widthInBlocks, heightInBlocks] = getFrameSizeInBlocks(this->cfg.blockSize, frame->info);
 
-    this->jobs.waitAndPush(job);
+    const auto nrSlices = std::clamp(this->cfg.nrSliceThreads, 1u, heightInBlocks);
+
+    auto sharedResult           = this->resultPool->get(widthInBlocks * heightInBlocks);
+    sharedResult->result.poc    = frame->stats.poc;
+    sharedResult->result.jobID  = this->frameCounter;
+    sharedResult->slicesPending = nrSlices;
+
+    sharedResult->dependenciesPending = 1;
+    if (this->previousFrame)
+    {
+        sharedResult->previous = this->previousFrame;
+        sharedResult->dependenciesPending++;
+        this->previousFrame->next = sharedResult;
+        if (this->previousFrame->linkState++ > 0)
+            sharedResult->dependenciesPending--;
+    }
+    this->previousFrame = sharedResult;
+
+    for (unsigned slice = 0; slice < nrSlices; slice++)
+    {
+        Job job;
+        job.frame                 = frame;
+        job.jobID                 = this->frameCounter;
+        job.macroblockRange.start = heightInBlocks * slice / nrSlices;
+        job.macroblockRange.end   = heightInBlocks * (slice + 1) / nrSlices;
+        job.sharedResult          = sharedResult;
+        job.computeEnergySlice    = this->computeEnergySlice;
+
+        if (this->cfg.enableStats)
+        {
+            auto depth = uint64_t(this->jobs.size());
+            addTicks(this->stats.jobQueueDepthSum, depth);
+            addTicks(this->stats.jobQueueDepthSamples, 1);
+            if (depth > this->stats.maxJobQueueDepth.load(std::memory_order_relaxed))
+                this->stats.maxJobQueueDepth.store(depth, std::memory_order_relaxed);
+
+            auto startTicks = readTicks();
+            this->jobs.waitAndPush(job);
+            addTicks(this->stats.pushWaitTicks, readTicks() - startTicks);
+        }
+        else
+            this->jobs.waitAndPush(job);
+    }
     this->frameCounter++;
+    if (this->cfg.enableStats)
+        addTicks(this->stats.frames, 1);
 
     return vca_result::VCA_OK;
 }
 
+void Analyzer::insertIntoReorderBuffer(std::shared_ptr<SharedResult> result)
+{
+    auto index = size_t(result->result.jobID - this->nextResultJobID);
+    if (index >= this->reorderBuffer.size())
+        this->reorderBuffer.resize(index + 1);
+    this->reorderBuffer[index] = std::move(result);
+}
+
 bool Analyzer::resultAvailable()
 {
-    return !this->results.empty();
+    while (auto result = this->results.tryPop())
+        this->insertIntoReorderBuffer(std::move(*result));
+
+    return !this->reorderBuffer.empty() && this->reorderBuffer.front();
+}
+
+std::shared_ptr<SharedResult> Analyzer::pullSharedResult()
+{
+    auto startTicks = this->cfg.enableStats ? readTicks() : 0;
+    while (this->reorderBuffer.empty() || !this->reorderBuffer.front())
+    {
+        auto result = this->results.waitAndPop();
+        if (!result)
+            return {};
+        this->insertIntoReorderBuffer(std::move(*result));
+    }
+    if (this->cfg.enableStats)
+        addTicks(this->stats.pullWaitTicks, readTicks() - startTicks);
+
+    auto sharedResult = std::move(this->reorderBuffer.front());
+    this->reorderBuffer.pop_front();
+    this->nextResultJobID++;
+    return sharedResult;
 }
 
 vca_result Analyzer::pullResult(vca_frame_results *outputResult)
 {
-    auto result = this->results.waitAndPop();
-    if (!result)
+    auto sharedResult = this->pullSharedResult();
+    if (!sharedResult)
         return vca_result::VCA_ERROR;
 
-    if (this->previousResult)
-    {
-        computeTextureSAD(*result, *this->previousResult);
+    const auto &result = sharedResult->result;
 
-        auto sadNormalized     = result->sad / result->averageEnergy;
-        auto sadNormalizedPrev = this->previousResult->sad / this->previousResult->averageEnergy;
-        if (this->previousResult->sad > 0)
-            result->epsilon = abs(sadNormalizedPrev - sadNormalized) / sadNormalizedPrev;
-    }
+    outputResult->poc           = result.poc;
+    outputResult->jobID         = result.jobID;
+    outputResult->averageEnergy = result.averageEnergy;
+    outputResult->sad           = result.sad;
+    outputResult->epsilon       = result.epsilon;
 
-    outputResult->poc           = result->poc;
-    outputResult->jobID         = result->jobID;
-    outputResult->averageEnergy = result->averageEnergy;
-    outputResult->sad           = result->sad;
-    outputResult->epsilon       = result->epsilon;
+    auto startTicks = this->cfg.enableStats ? readTicks() : 0;
     if (outputResult->energyPerBlock)
         std::memcpy(outputResult->energyPerBlock,
-                    result->energyPerBlock.data(),
-                    result->energyPerBlock.size() * sizeof(uint32_t));
+                    result.energyPerBlock.data(),
+                    result.energyPerBlock.size() * sizeof(uint32_t));
     if (outputResult->sadPerBlock)
         std::memcpy(outputResult->sadPerBlock,
-                    result->sadPerBlock.data(),
-                    result->sadPerBlock.size() * sizeof(uint32_t));
+                    result.sadPerBlock.data(),
+                    result.sadPerBlock.size() * sizeof(uint32_t));
+    if (this->cfg.enableStats)
+        addTicks(this->stats.pullCopyTicks, readTicks() - startTicks);
 
-    this->previousResult = result;
+    return vca_result::VCA_OK;
+}
 
+vca_result Analyzer::borrowResult(const vca_borrowed_frame_results **outputResult)
+{
+    auto sharedResult = this->pullSharedResult();
+    if (!sharedResult)
+        return vca_result::VCA_ERROR;
+
+    auto &result            = sharedResult->result;
+    auto &borrowed          = sharedResult->borrowedResult;
+    borrowed.poc            = result.poc;
+    borrowed.jobID          = result.jobID;
+    borrowed.averageEnergy  = result.averageEnergy;
+    borrowed.sad            = result.sad;
+    borrowed.epsilon        = result.epsilon;
+    borrowed.energyPerBlock = result.energyPerBlock.data();
+    borrowed.sadPerBlock    = result.sadPerBlock.data();
+
+    std::unique_lock<std::mutex> lock(this->borrowedResultsMutex);
+    this->borrowedResults[&borrowed] = std::move(sharedResult);
+    *outputResult                    = &borrowed;
+    return vca_result::VCA_OK;
+}
+
+void Analyzer::releaseResult(const vca_borrowed_frame_results *result)
+{
+    std::unique_lock<std::mutex> lock(this->borrowedResultsMutex);
+    if (this->borrowedResults.erase(result) == 0)
+        log(this->cfg, LogLevel::Warning, "Released a result that was not borrowed");
+}
+
+vca_result Analyzer::getStats(vca_analyzer_stats *outputStats)
+{
+    if (!this->cfg.enableStats)
+    {
+        log(this->cfg, LogLevel::Error, "Stats requested but enableStats is not set");
+        return vca_result::VCA_ERROR;
+    }
+
+    const auto toNs = [this](const std::atomic<uint64_t> &ticks) {
+        return this->tickConverter.toNanoseconds(ticks.load(std::memory_order_relaxed));
+    };
+
+    vca_analyzer_stats stats;
+    stats.frames     = this->stats.frames.load(std::memory_order_relaxed);
+    stats.pushWaitNs = toNs(this->stats.pushWaitTicks);
+    stats.pullWaitNs = toNs(this->stats.pullWaitTicks);
+    stats.pullCopyNs = toNs(this->stats.pullCopyTicks);
+    for (const auto &thread : this->threadPool)
+    {
+        const auto &threadStats = thread->getStats();
+        stats.jobs += threadStats.jobs.load(std::memory_order_relaxed);
+        stats.copyNs += toNs(threadStats.copyTicks);
+        stats.transformNs += toNs(threadStats.transformTicks);
+        stats.weightedSumNs += toNs(threadStats.weightedSumTicks);
+        stats.sadNs += toNs(threadStats.sadTicks);
+    }
+
+    stats.jobQueueDepth    = unsigned(this->jobs.size());
+    stats.resultQueueDepth = unsigned(this->results.size());
+    if (auto samples = this->stats.jobQueueDepthSamples.load(std::memory_order_relaxed))
+        stats.averageJobQueueDepth = double(this->stats.jobQueueDepthSum.load()) / double(samples);
+    stats.maxJobQueueDepth = unsigned(this->stats.maxJobQueueDepth.load());
+    stats.nrThreads        = unsigned(this->threadPool.size());
+
+    *outputStats = stats;
+    return vca_result::VCA_OK;
+}
+
+vca_result Analyzer::getThreadStats(unsigned threadIndex, vca_thread_stats *outputStats)
+{
+    if (!this->cfg.enableStats)
+    {
+        log(this->cfg, LogLevel::Error, "Stats requested but enableStats is not set");
+        return vca_result::VCA_ERROR;
+    }
+    if (threadIndex >= this->threadPool.size())
+        return vca_result::VCA_ERROR;
+
+    const auto &threadStats = this->threadPool[threadIndex]->getStats();
+    outputStats->busyNs     = this->tickConverter.toNanoseconds(threadStats.busyTicks.load());
+    outputStats->idleNs     = this->tickConverter.toNanoseconds(threadStats.idleTicks.load());
+    outputStats->jobs       = threadStats.jobs.load();
     return vca_result::VCA_OK;
 }
 
@@ -166,7 +328,7 @@ bool Analyzer::checkFrame(const vca_frame *frame)
 
     if (!this->frameInfo)
     {
-        if (info.bitDepth < 8 || info.bitDepth > 16)
+        if (info.bitDepth < 8 || info.bitDepth > 12)
         {
             log(this->cfg,
                 LogLevel::Error,
@@ -181,7 +343,15 @@ bool Analyzer::checkFrame(const vca_frame *frame)
                     + std::to_string(info.height) + " depth provided");
             return false;
         }
-        this->frameInfo = info;
+        if (this->cfg.blockSize != 8 && this->cfg.blockSize != 16 && this->cfg.blockSize != 32)
+        {
+            log(this->cfg,
+                LogLevel::Error,
+                "Invalid block size " + std::to_string(this->cfg.blockSize));
+            return false;
+        }
+        this->frameInfo          = info;
+        this->computeEnergySlice = getEnergySliceFunction(this->cfg.blockSize, info.bitDepth);
     }
 
     if (info.bitDepth != this->frameInfo->bitDepth || info.width != this->frameInfo->width
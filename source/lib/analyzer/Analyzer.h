@@ -21,13 +21,18 @@
 #include "vcaLib.h"
 
 #include "common.h"
-#include "MultiThreadQueue.h"
+#include "WorkQueue.h"
+#include "Primitives.h"
 #include "ProcessingThread.h"
+#include "ResultPool.h"
+#include "Stats.h"
 
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <unordered_map>
 
 namespace vca {
 
@@ -40,19 +45,45 @@ public:
     vca_result pushFrame(vca_frame *frame);
     bool resultAvailable();
     vca_result pullResult(vca_frame_results *result);
+    vca_result borrowResult(const vca_borrowed_frame_results **result);
+    void releaseResult(const vca_borrowed_frame_results *result);
+    vca_result getStats(vca_analyzer_stats *stats);
+    vca_result getThreadStats(unsigned threadIndex, vca_thread_stats *stats);
 
 private:
     vca_param cfg{};
     bool checkFrame(const vca_frame *frame);
+    void insertIntoReorderBuffer(std::shared_ptr<SharedResult> result);
+    std::shared_ptr<SharedResult> pullSharedResult();
     std::optional<vca_frame_info> frameInfo;
     unsigned frameCounter{0};
 
+    // The kernels for the selected SIMD level. Shared by all worker threads.
+    EnergyPrimitives primitives;
+    // The energy calculation for the block size and bit depth. Set with the first frame.
+    energy_slice_t computeEnergySlice{};
+
     std::vector<std::unique_ptr<ProcessingThread>> threadPool;
 
-    MultiThreadQueue<Job> jobs;
-    MultiThreadQueue<Result> results;
+    std::shared_ptr<ResultPool> resultPool;
+    JobQueue jobs;
+    ResultQueue results;
+
+    // Results are put back in order of the jobID here before they are returned.
+    // The front of the buffer is the slot for the result with nextResultJobID.
+    std::deque<std::shared_ptr<SharedResult>> reorderBuffer;
+    unsigned nextResultJobID{0};
+
+    std::mutex borrowedResultsMutex;
+    std::unordered_map<const vca_borrowed_frame_results *, std::shared_ptr<SharedResult>>
+        borrowedResults;
+
+    // The last pushed frame. The next frame is linked to it.
+    std::shared_ptr<SharedResult> previousFrame;
 
-    std::optional<Result> previousResult;
+    // Only updated if enableStats is set
+    AnalyzerStats stats;
+    TickConverter tickConverter;
 };
 
 } // namespace vca
@@ -26,8 +26,6 @@
 #include "DCTTransforms.h"
 #include "common.h"
 
-#include <cstring>
-
 namespace {
 
 const int16_t g_t8[8][8] = {{64, 64, 64, 64, 64, 64, 64, 64},
@@ -123,7 +121,12 @@ const int16_t g_t32[32][32]
        {4,  -13, 22, -31, 38, -46, 54, -61, 67, -73, 78, -82, 85, -88, 90, -90,
         90, -90, 88, -85, 82, -78, 73, -67, 61, -54, 46, -38, 31, -22, 13, -4}};
 
-static void partialButterfly8(const int16_t *src, int16_t *dst, int shift, int line)
+template<typename PixelType>
+void partialButterfly8(const PixelType *src,
+                      intptr_t srcStride,
+                      int16_t *dst,
+                      int shift,
+                      int line)
 {
     int j, k;
     int E[4], O[4];
@@ -163,12 +166,17 @@ static void partialButterfly8(const int16_t *src, int16_t *dst, int shift, int l
             (g_t8[7][0] * O[0] + g_t8[7][1] * O[1] + g_t8[7][2] * O[2] + g_t8[7][3] * O[3] + add)
             >> shift);
 
-        src += 8;
+        src += srcStride;
         dst++;
     }
 }
 
-static void partialButterfly16(const int16_t *src, int16_t *dst, int shift, int line)
+template<typename PixelType>
+void partialButterfly16(const PixelType *src,
+                       intptr_t srcStride,
+                       int16_t *dst,
+                       int shift,
+                       int line)
 {
     int j, k;
     int E[8], O[8];
@@ -218,12 +226,17 @@ static void partialButterfly16(const int16_t *src, int16_t *dst, int shift, int
                                       >> shift);
         }
 
-        src += 16;
+        src += srcStride;
         dst++;
     }
 }
 
-static void partialButterfly32(const int16_t *src, int16_t *dst, int shift, int line)
+template<typename PixelType>
+void partialButterfly32(const PixelType *src,
+                       intptr_t srcStride,
+                       int16_t *dst,
+                       int shift,
+                       int line)
 {
     int j, k;
     int E[16], O[16];
@@ -292,67 +305,97 @@ static void partialButterfly32(const int16_t *src, int16_t *dst, int shift, int
                 >> shift);
         }
 
-        src += 32;
+        src += srcStride;
         dst++;
     }
 }
 
-} // namespace
-
-namespace vca {
-
-// TODO: I think for the other bit depths (10, 12), we just have to adapt the shift (shift_1st) in
-// these functions.
-
-void dct8_c(const int16_t *src, int16_t *dst, intptr_t srcStride)
+template<typename PixelType>
+void dct8(const PixelType *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth)
 {
-    const int shift_1st = 2;
+    const int shift_1st = 2 + int(bitDepth) - 8;
     const int shift_2nd = 9;
 
     ALIGN_VAR_32(int16_t, coef[8 * 8]);
-    ALIGN_VAR_32(int16_t, block[8 * 8]);
 
-    for (int i = 0; i < 8; i++)
-    {
-        std::memcpy(&block[i * 8], &src[i * srcStride], 8 * sizeof(int16_t));
-    }
-
-    partialButterfly8(block, coef, shift_1st, 8);
-    partialButterfly8(coef, dst, shift_2nd, 8);
+    // The first stage reads the samples directly from the source
+    partialButterfly8(src, srcStride, coef, shift_1st, 8);
+    partialButterfly8(coef, 8, dst, shift_2nd, 8);
 }
 
-void dct16_c(const int16_t *src, int16_t *dst, intptr_t srcStride)
+template<typename PixelType>
+void dct16(const PixelType *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth)
 {
-    const int shift_1st = 3;
+    const int shift_1st = 3 + int(bitDepth) - 8;
     const int shift_2nd = 10;
 
     ALIGN_VAR_32(int16_t, coef[16 * 16]);
-    ALIGN_VAR_32(int16_t, block[16 * 16]);
 
-    for (int i = 0; i < 16; i++)
-    {
-        std::memcpy(&block[i * 16], &src[i * srcStride], 16 * sizeof(int16_t));
-    }
-
-    partialButterfly16(block, coef, shift_1st, 16);
-    partialButterfly16(coef, dst, shift_2nd, 16);
+    // The first stage reads the samples directly from the source
+    partialButterfly16(src, srcStride, coef, shift_1st, 16);
+    partialButterfly16(coef, 16, dst, shift_2nd, 16);
 }
 
-void dct32_c(const int16_t *src, int16_t *dst, intptr_t srcStride)
+template<typename PixelType>
+void dct32(const PixelType *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth)
 {
-    const int shift_1st = 4;
+    const int shift_1st = 4 + int(bitDepth) - 8;
     const int shift_2nd = 11;
 
     ALIGN_VAR_32(int16_t, coef[32 * 32]);
-    ALIGN_VAR_32(int16_t, block[32 * 32]);
 
-    for (int i = 0; i < 32; i++)
-    {
-        std::memcpy(&block[i * 32], &src[i * srcStride], 32 * sizeof(int16_t));
-    }
+    // The first stage reads the samples directly from the source
+    partialButterfly32(src, srcStride, coef, shift_1st, 32);
+    partialButterfly32(coef, 32, dst, shift_2nd, 32);
+}
+
+} // namespace
+
+namespace vca {
+
+void dct8_c(const int16_t *src, int16_t *dst, intptr_t srcStride)
+{
+    dct8(src, dst, srcStride, 8);
+}
 
-    partialButterfly32(block, coef, shift_1st, 32);
-    partialButterfly32(coef, dst, shift_2nd, 32);
+void dct16_c(const int16_t *src, int16_t *dst, intptr_t srcStride)
+{
+    dct16(src, dst, srcStride, 8);
+}
+
+void dct32_c(const int16_t *src, int16_t *dst, intptr_t srcStride)
+{
+    dct32(src, dst, srcStride, 8);
+}
+
+void dct8_u8_c(const uint8_t *src, int16_t *dst, intptr_t srcStride)
+{
+    dct8(src, dst, srcStride, 8);
+}
+
+void dct16_u8_c(const uint8_t *src, int16_t *dst, intptr_t srcStride)
+{
+    dct16(src, dst, srcStride, 8);
+}
+
+void dct32_u8_c(const uint8_t *src, int16_t *dst, intptr_t srcStride)
+{
+    dct32(src, dst, srcStride, 8);
+}
+
+void dct8_u16_c(const uint16_t *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth)
+{
+    dct8(src, dst, srcStride, bitDepth);
+}
+
+void dct16_u16_c(const uint16_t *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth)
+{
+    dct16(src, dst, srcStride, bitDepth);
+}
+
+void dct32_u16_c(const uint16_t *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth)
+{
+    dct32(src, dst, srcStride, bitDepth);
 }
 
 } // namespace vca
@@ -30,9 +30,22 @@
 namespace vca {
 
 typedef void (*dct_t)(const int16_t *src, int16_t *dst, intptr_t srcStride);
+typedef void (*dct_u8_t)(const uint8_t *src, int16_t *dst, intptr_t srcStride);
+typedef void (*dct_u16_t)(const uint16_t *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth);
 
 void dct8_c(const int16_t *src, int16_t *dst, intptr_t srcStride);
 void dct16_c(const int16_t *src, int16_t *dst, intptr_t srcStride);
 void dct32_c(const int16_t *src, int16_t *dst, intptr_t srcStride);
 
+// Same transforms but reading 8 bit samples directly from the frame
+void dct8_u8_c(const uint8_t *src, int16_t *dst, intptr_t srcStride);
+void dct16_u8_c(const uint8_t *src, int16_t *dst, intptr_t srcStride);
+void dct32_u8_c(const uint8_t *src, int16_t *dst, intptr_t srcStride);
+
+// Same transforms for high bit depth samples. The first stage shift is adapted to the bit depth
+// so that the coefficients have the same range as for 8 bit input.
+void dct8_u16_c(const uint16_t *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth);
+void dct16_u16_c(const uint16_t *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth);
+void dct32_u16_c(const uint16_t *src, int16_t *dst, intptr_t srcStride, unsigned bitDepth);
+
 } // namespace vca
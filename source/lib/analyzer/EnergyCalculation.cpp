@@ -20,168 +20,118 @@
 
 #include "EnergyCalculation.h"
 
-#include "DCTTransforms.h"
-#include "simd/dct-ssse3.h"
-#include "simd/dct8.h"
-
 #include <algorithm>
 #include <cstdlib>
-#include <cstring>
 #include <stdexcept>
 
 namespace {
 
-// TODO: Convert this into a integer operation. That should be possible in 16 bit
-//       arithmetic with the same precision.
+// The weight of the coefficient (i, j) of a NxN block is 255 * e^((((i + 1)(j + 1)) / N^2)^2 - 1)
+// truncated to an integer. So the weights rise from about 93 to 255 with the frequency. The DC
+// coefficient is not weighted and the two lowest AC coefficients have a fixed weight of 27.
+//
+// The weights are stored multiplied by 256 so that the weighted sum can be calculated with a
+// 16 bit multiply-high: ((weight << 8) * abs(coeff)) >> 16 == (weight * abs(coeff)) >> 8.
 
-static const int16_t weights_dct8[64] = {
-    0,  27, 94,  94,  94,  94,  94,  95,  27, 94, 94,  95,  96,  97,  98,  99,
-    94, 94, 95,  97,  99,  101, 104, 107, 94, 95, 97,  99,  103, 107, 113, 120,
-    94, 96, 99,  103, 109, 116, 126, 138, 94, 97, 101, 107, 116, 128, 144, 164,
-    94, 98, 104, 113, 126, 144, 168, 201, 95, 99, 107, 120, 138, 164, 201, 255,
-};
+constexpr double constexprExp(double x)
+{
+    // The Taylor series converges quickly enough for the arguments in [-1, 0] used here
+    double sum  = 1.0;
+    double term = 1.0;
+    for (int n = 1; n < 40; n++)
+    {
+        term *= x / n;
+        sum += term;
+    }
+    return sum;
+}
 
-static const int16_t weights_dct16[256] = {
-    0,   27,  93,  93,  93,  93,  93,  93,  93,  93,  93,  94,  94,  94,  94,  94,  27,  93,  93,
-    93,  93,  94,  94,  94,  94,  94,  94,  94,  94,  94,  95,  95,  93,  93,  93,  94,  94,  94,
-    94,  94,  94,  95,  95,  95,  96,  96,  96,  97,  93,  93,  94,  94,  94,  94,  94,  95,  95,
-    96,  96,  97,  97,  98,  99,  99,  93,  93,  94,  94,  94,  95,  95,  96,  96,  97,  98,  99,
-    100, 101, 102, 103, 93,  94,  94,  94,  95,  95,  96,  97,  98,  99,  100, 101, 102, 104, 106,
-    107, 93,  94,  94,  94,  95,  96,  97,  98,  99,  101, 102, 104, 106, 108, 110, 113, 93,  94,
-    94,  95,  96,  97,  98,  99,  101, 103, 105, 107, 110, 113, 116, 120, 93,  94,  94,  95,  96,
-    98,  99,  101, 103, 106, 108, 112, 115, 119, 123, 128, 93,  94,  95,  96,  97,  99,  101, 103,
-    106, 109, 112, 116, 121, 126, 132, 138, 93,  94,  95,  96,  98,  100, 102, 105, 108, 112, 117,
-    122, 128, 134, 142, 150, 94,  94,  95,  97,  99,  101, 104, 107, 112, 116, 122, 128, 135, 144,
-    153, 164, 94,  94,  96,  97,  100, 102, 106, 110, 115, 121, 128, 135, 145, 155, 167, 181, 94,
-    94,  96,  98,  101, 104, 108, 113, 119, 126, 134, 144, 155, 168, 183, 201, 94,  95,  96,  99,
-    102, 106, 110, 116, 123, 132, 142, 153, 167, 183, 203, 225, 94,  95,  97,  99,  103, 107, 113,
-    120, 128, 138, 150, 164, 181, 201, 225, 255,
+template<unsigned blockSize> struct WeightTable
+{
+    alignas(32) uint16_t factors[blockSize * blockSize];
 };
 
-static const int16_t weights_dct32[1024] = {
-    0,   27,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,
-    93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  27,  93,  93,  93,  93,  93,
-    93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  94,  94,
-    94,  94,  94,  94,  94,  94,  94,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,
-    93,  93,  93,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,
-    94,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  93,  94,  94,  94,  94,  94,  94,  94,
-    94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  95,  95,  95,  95,  93,  93,  93,  93,  93,
-    93,  93,  93,  93,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  95,
-    95,  95,  95,  95,  95,  95,  95,  96,  93,  93,  93,  93,  93,  93,  93,  94,  94,  94,  94,
-    94,  94,  94,  94,  94,  94,  94,  94,  95,  95,  95,  95,  95,  95,  96,  96,  96,  96,  96,
-    96,  97,  93,  93,  93,  93,  93,  93,  94,  94,  94,  94,  94,  94,  94,  94,  94,  94,  95,
-    95,  95,  95,  95,  95,  96,  96,  96,  96,  97,  97,  97,  97,  98,  98,  93,  93,  93,  93,
-    93,  94,  94,  94,  94,  94,  94,  94,  94,  94,  95,  95,  95,  95,  95,  96,  96,  96,  96,
-    97,  97,  97,  98,  98,  98,  99,  99,  99,  93,  93,  93,  93,  93,  94,  94,  94,  94,  94,
-    94,  94,  95,  95,  95,  95,  95,  96,  96,  96,  97,  97,  97,  98,  98,  98,  99,  99,  100,
-    100, 101, 101, 93,  93,  93,  93,  94,  94,  94,  94,  94,  94,  94,  95,  95,  95,  95,  96,
-    96,  96,  97,  97,  97,  98,  98,  99,  99,  100, 100, 101, 101, 102, 102, 103, 93,  93,  93,
-    93,  94,  94,  94,  94,  94,  94,  95,  95,  95,  95,  96,  96,  96,  97,  97,  98,  98,  99,
-    99,  100, 100, 101, 102, 102, 103, 104, 104, 105, 93,  93,  93,  94,  94,  94,  94,  94,  94,
-    95,  95,  95,  96,  96,  96,  97,  97,  98,  98,  99,  99,  100, 100, 101, 102, 102, 103, 104,
-    105, 106, 107, 107, 93,  93,  93,  94,  94,  94,  94,  94,  95,  95,  95,  96,  96,  96,  97,
-    97,  98,  98,  99,  100, 100, 101, 102, 102, 103, 104, 105, 106, 107, 108, 109, 110, 93,  93,
-    93,  94,  94,  94,  94,  94,  95,  95,  95,  96,  96,  97,  97,  98,  99,  99,  100, 101, 101,
-    102, 103, 104, 105, 106, 107, 108, 109, 110, 112, 113, 93,  93,  93,  94,  94,  94,  94,  95,
-    95,  95,  96,  96,  97,  97,  98,  99,  99,  100, 101, 102, 103, 104, 105, 106, 107, 108, 109,
-    110, 112, 113, 115, 116, 93,  93,  94,  94,  94,  94,  94,  95,  95,  96,  96,  97,  97,  98,
-    99,  99,  100, 101, 102, 103, 104, 105, 106, 107, 109, 110, 112, 113, 115, 116, 118, 120, 93,
-    93,  94,  94,  94,  94,  95,  95,  95,  96,  96,  97,  98,  99,  99,  100, 101, 102, 103, 104,
-    105, 107, 108, 109, 111, 113, 114, 116, 118, 120, 122, 124, 93,  93,  94,  94,  94,  94,  95,
-    95,  96,  96,  97,  98,  98,  99,  100, 101, 102, 103, 104, 106, 107, 108, 110, 112, 113, 115,
-    117, 119, 121, 123, 126, 128, 93,  93,  94,  94,  94,  94,  95,  95,  96,  97,  97,  98,  99,
-    100, 101, 102, 103, 104, 106, 107, 109, 110, 112, 114, 116, 118, 120, 122, 125, 127, 130, 133,
-    93,  93,  94,  94,  94,  95,  95,  96,  96,  97,  98,  99,  100, 101, 102, 103, 104, 106, 107,
-    109, 110, 112, 114, 116, 119, 121, 123, 126, 129, 132, 135, 138, 93,  93,  94,  94,  94,  95,
-    95,  96,  97,  97,  98,  99,  100, 101, 103, 104, 105, 107, 109, 110, 112, 114, 117, 119, 122,
-    124, 127, 130, 133, 136, 140, 144, 93,  93,  94,  94,  94,  95,  95,  96,  97,  98,  99,  100,
-    101, 102, 104, 105, 107, 108, 110, 112, 114, 117, 119, 122, 125, 128, 131, 134, 138, 142, 146,
-    150, 93,  93,  94,  94,  94,  95,  96,  96,  97,  98,  99,  100, 102, 103, 105, 106, 108, 110,
-    112, 114, 117, 119, 122, 125, 128, 131, 135, 139, 143, 147, 152, 157, 93,  94,  94,  94,  95,
-    95,  96,  97,  98,  99,  100, 101, 102, 104, 106, 107, 109, 112, 114, 116, 119, 122, 125, 128,
-    132, 135, 140, 144, 148, 153, 159, 164, 93,  94,  94,  94,  95,  95,  96,  97,  98,  99,  100,
-    102, 103, 105, 107, 109, 111, 113, 116, 119, 122, 125, 128, 132, 136, 140, 144, 149, 154, 160,
-    166, 172, 93,  94,  94,  94,  95,  96,  96,  97,  98,  100, 101, 102, 104, 106, 108, 110, 113,
-    115, 118, 121, 124, 128, 131, 135, 140, 145, 150, 155, 161, 167, 174, 181, 93,  94,  94,  94,
-    95,  96,  97,  98,  99,  100, 102, 103, 105, 107, 109, 112, 114, 117, 120, 123, 127, 131, 135,
-    140, 144, 150, 155, 161, 168, 175, 182, 191, 93,  94,  94,  94,  95,  96,  97,  98,  99,  101,
-    102, 104, 106, 108, 110, 113, 116, 119, 122, 126, 130, 134, 139, 144, 149, 155, 161, 168, 175,
-    183, 192, 201, 93,  94,  94,  95,  95,  96,  97,  98,  100, 101, 103, 105, 107, 109, 112, 115,
-    118, 121, 125, 129, 133, 138, 143, 148, 154, 161, 168, 175, 184, 193, 202, 213, 93,  94,  94,
-    95,  95,  96,  97,  99,  100, 102, 104, 106, 108, 110, 113, 116, 120, 123, 127, 132, 136, 142,
-    147, 153, 160, 167, 175, 183, 193, 203, 214, 225, 93,  94,  94,  95,  95,  96,  98,  99,  101,
-    102, 104, 107, 109, 112, 115, 118, 122, 126, 130, 135, 140, 146, 152, 159, 166, 174, 182, 192,
-    202, 214, 226, 239, 93,  94,  94,  95,  96,  97,  98,  99,  101, 103, 105, 107, 110, 113, 116,
-    120, 124, 128, 133, 138, 144, 150, 157, 164, 172, 181, 191, 201, 213, 225, 239, 255,
-};
+template<unsigned blockSize> constexpr WeightTable<blockSize> makeWeightTable()
+{
+    WeightTable<blockSize> table{};
+    for (unsigned i = 0; i < blockSize; i++)
+        for (unsigned j = 0; j < blockSize; j++)
+        {
+            const auto frequency = double((i + 1) * (j + 1)) / double(blockSize * blockSize);
+            const auto weight    = unsigned(255.0 * constexprExp(frequency * frequency - 1.0));
+            table.factors[i * blockSize + j] = uint16_t(weight << 8);
+        }
+    table.factors[0]         = 0;
+    table.factors[1]         = 27 << 8;
+    table.factors[blockSize] = 27 << 8;
+    return table;
+}
+
+constexpr auto weights_dct8  = makeWeightTable<8>();
+constexpr auto weights_dct16 = makeWeightTable<16>();
+constexpr auto weights_dct32 = makeWeightTable<32>();
+
+static_assert(weights_dct8.factors[63] == 255 << 8 && weights_dct8.factors[2] == 94 << 8);
+static_assert(weights_dct32.factors[1023] == 255 << 8 && weights_dct32.factors[2] == 93 << 8);
 
 static const double E_norm_factor = 90;
 static const double h_norm_factor = 18;
 
-uint32_t calculateWeightedCoeffSum(unsigned blockSize, int16_t *coeffBuffer)
-{
-    uint32_t weightedSum = 0;
+} // namespace
+
+namespace vca {
 
-    auto weightFactorMatrix = weights_dct32;
+const uint16_t *getWeightFactorMatrix(unsigned blockSize)
+{
     switch (blockSize)
     {
         case 32:
-            weightFactorMatrix = weights_dct32;
-            break;
+            return weights_dct32.factors;
         case 16:
-            weightFactorMatrix = weights_dct16;
-            break;
+            return weights_dct16.factors;
         case 8:
-            weightFactorMatrix = weights_dct8;
-            break;
-    }
-
-    for (unsigned i = 0; i < blockSize * blockSize; i++)
-    {
-        auto weightedCoeff = (uint32_t)((weightFactorMatrix[i] * std::abs(coeffBuffer[i])) >> 8);
-        weightedSum += weightedCoeff;
+            return weights_dct8.factors;
+        default:
+            throw std::invalid_argument("Invalid block size " + std::to_string(blockSize));
     }
-
-    return weightedSum;
 }
 
-void copyPixelValuesToBuffer(unsigned blockOffsetLuma,
+void copyPixelValuesToBuffer(const uint8_t *src,
                              unsigned blockSize,
-                             unsigned bitDepth,
-                             uint8_t *src,
                              unsigned srcStride,
                              int16_t *buffer)
 {
-    if (bitDepth == 8)
-    {
-        src += blockOffsetLuma;
-        for (unsigned y = 0; y < blockSize; y++, src += srcStride)
-            for (unsigned x = 0; x < blockSize; x++)
-                *(buffer++) = int16_t(src[x]);
-    }
-    else
-    {
-        auto input = (int16_t *) (src) + blockOffsetLuma;
-        for (unsigned y = 0; y < blockSize; y++, input += srcStride / 2, buffer += blockSize)
-            std::memcpy(buffer, input, blockSize * sizeof(int16_t));
-    }
+    for (unsigned y = 0; y < blockSize; y++, src += srcStride)
+        for (unsigned x = 0; x < blockSize; x++)
+            *(buffer++) = int16_t(src[x]);
 }
 
-template<int bitDepth>
-void copyPixelValuesToBufferWithPadding(unsigned blockOffsetLuma,
-                                        unsigned blockSize,
-                                        uint8_t *srcData,
-                                        unsigned srcStride,
-                                        int16_t *buffer,
-                                        unsigned paddingRight,
-                                        unsigned paddingBottom)
-{
-    typedef typename std::conditional<bitDepth == 8, uint8_t *, int16_t *>::type InValueType;
-    static_assert(bitDepth >= 8 && bitDepth <= 16);
+} // namespace vca
+
+namespace {
 
-    const auto *__restrict src = InValueType(srcData);
+using namespace vca;
 
-    src += blockOffsetLuma;
+template<unsigned blockSize> constexpr const uint16_t *weightFactorMatrix()
+{
+    static_assert(blockSize == 8 || blockSize == 16 || blockSize == 32);
+    if constexpr (blockSize == 8)
+        return weights_dct8.factors;
+    else if constexpr (blockSize == 16)
+        return weights_dct16.factors;
+    else
+        return weights_dct32.factors;
+}
+
+// Copy a block which exceeds the frame at the right or bottom into the buffer. The samples
+// outside of the frame repeat the last column and row inside of the frame.
+template<unsigned blockSize, typename SampleType>
+void copyBlockWithPadding(const SampleType *__restrict src,
+                          unsigned srcStride,
+                          int16_t *buffer,
+                          unsigned paddingRight,
+                          unsigned paddingBottom)
+{
     unsigned y          = 0;
     auto bufferLastLine = buffer;
     for (; y < blockSize - paddingBottom; y++, src += srcStride)
@@ -201,125 +151,248 @@ void copyPixelValuesToBufferWithPadding(unsigned blockOffsetLuma,
     }
 }
 
-void performDCT(unsigned blockSize, int16_t *pixelBuffer, int16_t *coeffBuffer, CpuSimd cpuSimd)
+// The energy calculation of one slice specialized for the block size and bit depth. So the
+// block size, the weight table and the kernel for the bit depth are constant in the block loop.
+template<unsigned blockSize, unsigned bitDepth>
+uint32_t computeWeightedDCTEnergySlice(const Job &job,
+                                       Result &result,
+                                       const EnergyPrimitives &primitives,
+                                       JobTicks *ticks)
+{
+    typedef typename std::conditional<bitDepth == 8, uint8_t, uint16_t>::type SampleType;
+
+    constexpr auto nrCoefficients = blockSize * blockSize;
+    constexpr auto weightFactors  = weightFactorMatrix<blockSize>();
+
+    const auto frame           = job.frame;
+    const auto &kernels        = primitives.get(blockSize);
+    const auto weightedSum     = primitives.weightedSum;
+    const auto dctHighBitDepth = (bitDepth == 10 || bitDepth == 12) ? kernels.dct_u16
+                                                                    : kernels.dct_u16_generic;
+
+    // The batched kernels transform 4 adjacent 8x8 blocks per call. These are not available for
+    // all SIMD levels and bit depths.
+    bool useEnergy8x4 = false;
+    if constexpr (blockSize == 8 && bitDepth == 8)
+        useEnergy8x4 = primitives.energy8x4_u8 != nullptr;
+    else if constexpr (blockSize == 8 && (bitDepth == 10 || bitDepth == 12))
+        useEnergy8x4 = primitives.energy8x4_u16 != nullptr;
+
+    // The frame stride is given in bytes. Offsets and strides below are in samples.
+    const auto src       = (const SampleType *) (frame->planes[0]);
+    const auto srcStride = unsigned(frame->stride[0]) / unsigned(sizeof(SampleType));
+
+    const auto widthInBlocks = getFrameSizeInBlocks(blockSize, frame->info).first;
+    const auto widthInPixels = widthInBlocks * blockSize;
+
+    // Interior blocks are transformed directly from the frame. Blocks at the right or bottom
+    // border need padding so these are copied into a temporary buffer which has one int16_t
+    // value per sample.
+
+    ALIGN_VAR_32(int16_t, pixelBuffer[blockSize * blockSize]);
+    ALIGN_VAR_32(int16_t, coeffBuffer[blockSize * blockSize]);
+
+    auto blockIndex          = job.macroblockRange.start * widthInBlocks;
+    uint32_t sliceTexture    = 0;
+    const auto sliceStartY   = job.macroblockRange.start * blockSize;
+    const auto sliceEndY     = job.macroblockRange.end * blockSize;
+    uint64_t blockStartTicks = ticks ? readTicks() : 0;
+    for (unsigned blockY = sliceStartY; blockY < sliceEndY; blockY += blockSize)
+    {
+        auto paddingBottom = std::max(int(blockY + blockSize) - int(frame->info.height), 0);
+        unsigned blockX    = 0;
+
+        // All blocks which need no padding are processed 4 at a time if possible. The time of
+        // the batched kernels is counted as transform time.
+        if (useEnergy8x4 && paddingBottom == 0)
+        {
+            for (; blockX + 4 * blockSize <= frame->info.width; blockX += 4 * blockSize)
+            {
+                const auto blockOffsetLuma = blockX + (blockY * srcStride);
+                const auto energies        = &result.energyPerBlock[blockIndex];
+                if constexpr (bitDepth == 8)
+                    primitives.energy8x4_u8(src + blockOffsetLuma,
+                                            srcStride,
+                                            weightFactors,
+                                            energies);
+                else
+                    primitives.energy8x4_u16(src + blockOffsetLuma,
+                                             srcStride,
+                                             weightFactors,
+                                             energies,
+                                             bitDepth);
+                sliceTexture += energies[0] + energies[1] + energies[2] + energies[3];
+                blockIndex += 4;
+            }
+
+            if (ticks)
+            {
+                const auto batchEndTicks = readTicks();
+                ticks->transform += batchEndTicks - blockStartTicks;
+                blockStartTicks = batchEndTicks;
+            }
+        }
+
+        for (; blockX < widthInPixels; blockX += blockSize)
+        {
+            auto paddingRight    = std::max(int(blockX + blockSize) - int(frame->info.width), 0);
+            auto blockOffsetLuma = blockX + (blockY * srcStride);
+
+            if (paddingRight > 0 || paddingBottom > 0)
+            {
+                copyBlockWithPadding<blockSize>(src + blockOffsetLuma,
+                                                srcStride,
+                                                pixelBuffer,
+                                                unsigned(paddingRight),
+                                                unsigned(paddingBottom));
+                if (ticks)
+                {
+                    const auto copyEndTicks = readTicks();
+                    ticks->copy += copyEndTicks - blockStartTicks;
+                    blockStartTicks = copyEndTicks;
+                }
+                if constexpr (bitDepth == 8)
+                    kernels.dct(pixelBuffer, coeffBuffer, blockSize);
+                else
+                    dctHighBitDepth((const uint16_t *) (pixelBuffer),
+                                    coeffBuffer,
+                                    blockSize,
+                                    bitDepth);
+            }
+            else if constexpr (bitDepth == 8)
+                kernels.dct_u8(src + blockOffsetLuma, coeffBuffer, srcStride);
+            else
+                dctHighBitDepth(src + blockOffsetLuma, coeffBuffer, srcStride, bitDepth);
+
+            uint64_t transformEndTicks{};
+            if (ticks)
+            {
+                transformEndTicks = readTicks();
+                ticks->transform += transformEndTicks - blockStartTicks;
+            }
+
+            result.energyPerBlock[blockIndex] = weightedSum(coeffBuffer,
+                                                            weightFactors,
+                                                            nrCoefficients);
+            sliceTexture += result.energyPerBlock[blockIndex];
+
+            if (ticks)
+            {
+                blockStartTicks = readTicks();
+                ticks->weightedSum += blockStartTicks - transformEndTicks;
+            }
+
+            blockIndex++;
+        }
+    }
+
+    return sliceTexture;
+}
+
+// The specializations for the bit depths 8 to 12 of one block size
+template<unsigned blockSize> struct EnergySliceFunctions
+{
+    static constexpr energy_slice_t byBitDepth[5] = {computeWeightedDCTEnergySlice<blockSize, 8>,
+                                                     computeWeightedDCTEnergySlice<blockSize, 9>,
+                                                     computeWeightedDCTEnergySlice<blockSize, 10>,
+                                                     computeWeightedDCTEnergySlice<blockSize, 11>,
+                                                     computeWeightedDCTEnergySlice<blockSize, 12>};
+};
+
+} // namespace
+
+namespace vca {
+
+energy_slice_t getEnergySliceFunction(unsigned blockSize, unsigned bitDepth)
 {
     switch (blockSize)
     {
+        case 8:
+            return EnergySliceFunctions<8>::byBitDepth[bitDepth - 8];
+        case 16:
+            return EnergySliceFunctions<16>::byBitDepth[bitDepth - 8];
         case 32:
-            if (cpuSimd == CpuSimd::AVX2)
-                vca_dct32_avx2(pixelBuffer, coeffBuffer, 32);
-            else if (cpuSimd == CpuSimd::SSSE3)
-                vca_dct32_ssse3(pixelBuffer, coeffBuffer, 32);
-            else
-                vca::dct32_c(pixelBuffer, coeffBuffer, 32);
+            return EnergySliceFunctions<32>::byBitDepth[bitDepth - 8];
+        default:
+            throw std::invalid_argument("Invalid block size " + std::to_string(blockSize));
+    }
+}
+
+template<int bitDepth>
+void copyPixelValuesToBufferWithPadding(unsigned blockOffsetLuma,
+                                        unsigned blockSize,
+                                        uint8_t *srcData,
+                                        unsigned srcStride,
+                                        int16_t *buffer,
+                                        unsigned paddingRight,
+                                        unsigned paddingBottom)
+{
+    typedef typename std::conditional<bitDepth == 8, uint8_t, int16_t>::type SampleType;
+    static_assert(bitDepth >= 8 && bitDepth <= 16);
+
+    const auto src = (const SampleType *) (srcData) + blockOffsetLuma;
+    switch (blockSize)
+    {
+        case 8:
+            copyBlockWithPadding<8>(src, srcStride, buffer, paddingRight, paddingBottom);
             break;
         case 16:
-            if (cpuSimd == CpuSimd::AVX2)
-                vca_dct16_avx2(pixelBuffer, coeffBuffer, 16);
-            else if (cpuSimd == CpuSimd::SSSE3)
-                vca_dct16_ssse3(pixelBuffer, coeffBuffer, 16);
-            else
-                vca::dct16_c(pixelBuffer, coeffBuffer, 16);
+            copyBlockWithPadding<16>(src, srcStride, buffer, paddingRight, paddingBottom);
             break;
-        case 8:
-            if (cpuSimd == CpuSimd::AVX2)
-                vca_dct8_avx2(pixelBuffer, coeffBuffer, 8);
-            else if (cpuSimd == CpuSimd::SSE4)
-                vca_dct8_sse4(pixelBuffer, coeffBuffer, 8);
-            else if (cpuSimd == CpuSimd::SSE2)
-                vca_dct8_sse2(pixelBuffer, coeffBuffer, 8);
-            else
-                vca::dct8_c(pixelBuffer, coeffBuffer, 8);
+        case 32:
+            copyBlockWithPadding<32>(src, srcStride, buffer, paddingRight, paddingBottom);
             break;
         default:
             throw std::invalid_argument("Invalid block size " + std::to_string(blockSize));
     }
 }
 
-} // namespace
-
-namespace vca {
-
-void computeWeightedDCTEnergy(const Job &job, Result &result, unsigned blockSize, CpuSimd cpuSimd)
+template void copyPixelValuesToBufferWithPadding<8>(unsigned blockOffsetLuma,
+                                                    unsigned blockSize,
+                                                    uint8_t *srcData,
+                                                    unsigned srcStride,
+                                                    int16_t *buffer,
+                                                    unsigned paddingRight,
+                                                    unsigned paddingBottom);
+template void copyPixelValuesToBufferWithPadding<16>(unsigned blockOffsetLuma,
+                                                     unsigned blockSize,
+                                                     uint8_t *srcData,
+                                                     unsigned srcStride,
+                                                     int16_t *buffer,
+                                                     unsigned paddingRight,
+                                                     unsigned paddingBottom);
+
+uint32_t computeWeightedDCTEnergy(const Job &job,
+                                  Result &result,
+                                  unsigned blockSize,
+                                  const EnergyPrimitives &primitives,
+                                  JobTicks *ticks)
 {
     const auto frame = job.frame;
     if (frame == nullptr)
         throw std::invalid_argument("Invalid frame pointer");
 
     const auto bitDepth = frame->info.bitDepth;
-
-    if (frame->info.bitDepth > 8)
-        throw std::invalid_argument("16 bit input not implemented yet");
-
-    auto src       = frame->planes[0];
-    auto srcStride = frame->stride[0];
+    if (bitDepth < 8 || bitDepth > 12)
+        throw std::invalid_argument("Unsupported bit depth " + std::to_string(bitDepth));
 
     auto [widthInBlocks, heightInBlock] = getFrameSizeInBlocks(blockSize, frame->info);
     auto totalNumberBlocks              = widthInBlocks * heightInBlock;
-    auto widthInPixels                  = widthInBlocks * blockSize;
-    auto heightInPixels                 = heightInBlock * blockSize;
 
+    // The result is shared by all slices of the frame so it must be allocated beforehand.
     if (result.energyPerBlock.size() < totalNumberBlocks)
-        result.energyPerBlock.resize(totalNumberBlocks);
-
-    // First, we will copy the source to a temporary buffer which has one int16_t value
-    // per sample.
-    //   - This may only be needed for 8 bit values. For 16 bit values we could also
-    //     perform this directly from the source buffer. However, we should check the
-    //     performance of that approach (i.e. the buffer may not be aligned)
-
-    ALIGN_VAR_32(int16_t, pixelBuffer[32 * 32]);
-    ALIGN_VAR_32(int16_t, coeffBuffer[32 * 32]);
-
-    auto blockIndex       = 0u;
-    uint32_t frameTexture = 0;
-    for (unsigned blockY = 0; blockY < heightInPixels; blockY += blockSize)
-    {
-        auto paddingBottom = std::max(int(blockY + blockSize) - int(frame->info.height), 0);
-        for (unsigned blockX = 0; blockX < widthInPixels; blockX += blockSize)
-        {
-            auto paddingRight    = std::max(int(blockX + blockSize) - int(frame->info.width), 0);
-            auto blockOffsetLuma = blockX + (blockY * srcStride);
-
-            if (paddingRight > 0 || paddingBottom > 0)
-            {
-                if (bitDepth == 8)
-                    copyPixelValuesToBufferWithPadding<8>(blockOffsetLuma,
-                                                          blockSize,
-                                                          src,
-                                                          srcStride,
-                                                          pixelBuffer,
-                                                          unsigned(paddingRight),
-                                                          unsigned(paddingBottom));
-                else
-                    copyPixelValuesToBufferWithPadding<16>(blockOffsetLuma,
-                                                           blockSize,
-                                                           src,
-                                                           srcStride / 2,
-                                                           pixelBuffer,
-                                                           unsigned(paddingRight),
-                                                           unsigned(paddingBottom));
-            }
-            else
-            {
-                copyPixelValuesToBuffer(blockOffsetLuma,
-                                        blockSize,
-                                        bitDepth,
-                                        src,
-                                        srcStride,
-                                        pixelBuffer);
-            }
-
-            performDCT(blockSize, pixelBuffer, coeffBuffer, cpuSimd);
+        throw std::out_of_range("Energy result vector too small");
+    if (job.macroblockRange.start >= job.macroblockRange.end
+        || job.macroblockRange.end > heightInBlock)
+        throw std::out_of_range("Invalid block row range");
 
-            result.energyPerBlock[blockIndex] = calculateWeightedCoeffSum(blockSize, coeffBuffer);
-            frameTexture += result.energyPerBlock[blockIndex];
-
-            blockIndex++;
-        }
-    }
+    return job.computeEnergySlice(job, result, primitives, ticks);
+}
 
-    result.averageEnergy = uint32_t((double) (frameTexture) / (totalNumberBlocks * E_norm_factor));
+void computeAverageEnergy(Result &result, uint32_t frameTexture)
+{
+    auto totalNumberBlocks = double(result.energyPerBlock.size());
+    result.averageEnergy   = uint32_t(double(frameTexture) / (totalNumberBlocks * E_norm_factor));
 }
 
 void computeTextureSAD(Result &result, const Result &resultsPreviousFrame)
@@ -342,4 +415,13 @@ void computeTextureSAD(Result &result, const Result &resultsPreviousFrame)
     result.sad = textureSad / (totalNumberBlocks * h_norm_factor);
 }
 
+void computeEpsilon(Result &result, const Result &resultsPreviousFrame)
+{
+    auto sadNormalized     = result.sad / result.averageEnergy;
+    auto sadNormalizedPrev = resultsPreviousFrame.sad / resultsPreviousFrame.averageEnergy;
+    if (resultsPreviousFrame.sad > 0)
+        // The difference is truncated to an integer which keeps the results of the original code
+        result.epsilon = std::abs(int(sadNormalizedPrev - sadNormalized)) / sadNormalizedPrev;
+}
+
 } // namespace vca
\ No newline at end of file
@@ -20,11 +20,42 @@
  
 #pragma once
 
+#include "Primitives.h"
+#include "Stats.h"
 #include "common.h"
 
 namespace vca {
 
-void computeWeightedDCTEnergy(const Job &job, Result &result, unsigned blockSize, CpuSimd cpuSimd);
+// Get the energy calculation of a slice for the block size and bit depth
+energy_slice_t getEnergySliceFunction(unsigned blockSize, unsigned bitDepth);
+
+// Calculate the energy for all blocks in the block rows of job.macroblockRange using
+// job.computeEnergySlice and return the sum of these energies. If ticks is set, the time spent
+// in the padding copy, the transform and the weighted sum is added to it.
+uint32_t computeWeightedDCTEnergy(const Job &job,
+                                  Result &result,
+                                  unsigned blockSize,
+                                  const EnergyPrimitives &primitives,
+                                  JobTicks *ticks);
+// The weights of the coefficients of a block for the weighted sum (multiplied by 256)
+const uint16_t *getWeightFactorMatrix(unsigned blockSize);
+// The kernels of the energy calculation. These are only exposed for the kernel benchmark.
+void copyPixelValuesToBuffer(const uint8_t *src,
+                             unsigned blockSize,
+                             unsigned srcStride,
+                             int16_t *buffer);
+// Instantiated for 8 and 16 bit samples
+template<int bitDepth>
+void copyPixelValuesToBufferWithPadding(unsigned blockOffsetLuma,
+                                        unsigned blockSize,
+                                        uint8_t *srcData,
+                                        unsigned srcStride,
+                                        int16_t *buffer,
+                                        unsigned paddingRight,
+                                        unsigned paddingBottom);
+
+void computeAverageEnergy(Result &result, uint32_t frameTexture);
 void computeTextureSAD(Result &results, const Result &resultsPreviousFrame);
+void computeEpsilon(Result &result, const Result &resultsPreviousFrame);
 
 } // namespace vca
@@ -0,0 +1,242 @@
+/* Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "LockFreeQueue.h"
+#include "common.h"
+
+#include <emmintrin.h>
+#include <thread>
+
+namespace {
+
+// How often a waiting thread polls the queue before it is parked. Spinning on a single
+// core only takes time away from the thread we are waiting for.
+const unsigned SpinCount = std::thread::hardware_concurrency() > 1 ? 1024 : 0;
+
+} // namespace
+
+namespace vca {
+
+template<class T>
+template<typename Predicate>
+void LockFreeQueue<T>::Parking::wait(Predicate predicate)
+{
+    for (unsigned i = 0; i < SpinCount; i++)
+    {
+        if (predicate())
+            return;
+        _mm_pause();
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->waiting++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    this->cv.wait(lock, predicate);
+    this->waiting--;
+}
+
+template<class T>
+void LockFreeQueue<T>::Parking::notify()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->waiting.load() == 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+    }
+    this->cv.notify_one();
+}
+
+template<class T>
+void LockFreeQueue<T>::Parking::notifyAll()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->waiting.load() == 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+    }
+    this->cv.notify_all();
+}
+
+template<class T>
+LockFreeQueue<T>::LockFreeQueue()
+{
+    this->setMaximumQueueSize(0);
+}
+
+template<class T>
+bool LockFreeQueue<T>::tryPushItem(T &item)
+{
+    auto position = this->pushPosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto &cell    = this->cells[position & this->mask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff     = intptr_t(sequence) - intptr_t(position);
+        if (diff == 0)
+        {
+            if (this->pushPosition.compare_exchange_weak(position,
+                                                         position + 1,
+                                                         std::memory_order_relaxed))
+            {
+                cell.data = std::move(item);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+            return false;
+        else
+            position = this->pushPosition.load(std::memory_order_relaxed);
+    }
+}
+
+template<class T>
+bool LockFreeQueue<T>::tryPopItem(T &item)
+{
+    auto position = this->popPosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto &cell    = this->cells[position & this->mask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff     = intptr_t(sequence) - intptr_t(position + 1);
+        if (diff == 0)
+        {
+            if (this->popPosition.compare_exchange_weak(position,
+                                                        position + 1,
+                                                        std::memory_order_relaxed))
+            {
+                item = std::move(cell.data);
+                cell.sequence.store(position + this->mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+            return false;
+        else
+            position = this->popPosition.load(std::memory_order_relaxed);
+    }
+}
+
+template<class T>
+bool LockFreeQueue<T>::slotFree()
+{
+    auto position = this->pushPosition.load(std::memory_order_relaxed);
+    auto sequence = this->cells[position & this->mask].sequence.load(std::memory_order_acquire);
+    return sequence == position;
+}
+
+template<class T>
+bool LockFreeQueue<T>::itemAvailable()
+{
+    auto position = this->popPosition.load(std::memory_order_relaxed);
+    auto sequence = this->cells[position & this->mask].sequence.load(std::memory_order_acquire);
+    return sequence == position + 1;
+}
+
+template<class T>
+void LockFreeQueue<T>::abort()
+{
+    this->aborted = true;
+    this->pushParking.notifyAll();
+    this->popParking.notifyAll();
+}
+
+template<class T>
+void LockFreeQueue<T>::waitAndPush(T item)
+{
+    if (this->aborted)
+        return;
+
+    while (!this->tryPushItem(item))
+    {
+        this->pushParking.wait([this]() { return this->slotFree() || this->aborted; });
+        if (this->aborted)
+            return;
+    }
+
+    this->popParking.notify();
+}
+
+template<class T>
+std::optional<T> LockFreeQueue<T>::waitAndPop()
+{
+    T item;
+    while (true)
+    {
+        if (this->aborted)
+            return {};
+        if (this->tryPopItem(item))
+            break;
+        this->popParking.wait([this]() { return this->itemAvailable() || this->aborted; });
+    }
+
+    this->pushParking.notify();
+    return item;
+}
+
+template<class T>
+std::optional<T> LockFreeQueue<T>::tryPop()
+{
+    T item;
+    if (this->aborted || !this->tryPopItem(item))
+        return {};
+
+    this->pushParking.notify();
+    return item;
+}
+
+template<class T>
+bool LockFreeQueue<T>::empty()
+{
+    if (this->aborted)
+        return false;
+
+    return !this->itemAvailable();
+}
+
+template<class T>
+size_t LockFreeQueue<T>::size()
+{
+    // Read the pop position first. The push position can only be larger or equal then.
+    auto popped = this->popPosition.load(std::memory_order_acquire);
+    auto pushed = this->pushPosition.load(std::memory_order_relaxed);
+    return pushed - popped;
+}
+
+template<class T>
+void LockFreeQueue<T>::setMaximumQueueSize(size_t max)
+{
+    size_t size = 2;
+    while (size < (max == 0 ? DefaultQueueSize : max))
+        size *= 2;
+
+    this->cells = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; i++)
+        this->cells[i].sequence.store(i, std::memory_order_relaxed);
+    this->mask = size - 1;
+
+    this->pushPosition = 0;
+    this->popPosition  = 0;
+}
+
+template class LockFreeQueue<Job>;
+template class LockFreeQueue<std::shared_ptr<SharedResult>>;
+
+} // namespace vca
@@ -0,0 +1,100 @@
+/* Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace vca {
+
+// A bounded multi producer / multi consumer queue with the same interface as the
+// MultiThreadQueue. Items are stored in a ring buffer where each cell carries a sequence
+// number, so pushing and popping only needs one compare and swap on the shared position.
+// Waiting threads first spin for a short while and are only parked on a condition variable
+// if the wait takes longer. Parked threads are only notified if there are any.
+template<class T>
+class LockFreeQueue
+{
+public:
+    LockFreeQueue();
+    ~LockFreeQueue() = default;
+
+    // Push an item to the queue. Wait if the queue is full.
+    void waitAndPush(T item);
+
+    // Get an item. If the queue is empty, wait until an item is pushed.
+    // Will return empty opt if abort is called.
+    std::optional<T> waitAndPop();
+    // Get an item if there is one. Never waits.
+    std::optional<T> tryPop();
+
+    void abort();
+    bool empty();
+    // The number of items in the queue. Only a snapshot if other threads use the queue.
+    size_t size();
+
+    // The queue can hold at least this many items. It is rounded up to the next power of two.
+    // Unlike the MultiThreadQueue, the queue is always bounded and 0 selects a default
+    // size of DefaultQueueSize items. Must be called before the queue is used.
+    void setMaximumQueueSize(size_t max);
+
+    static constexpr size_t DefaultQueueSize = 1024;
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{};
+        T data{};
+    };
+
+    class Parking
+    {
+    public:
+        template<typename Predicate>
+        void wait(Predicate predicate);
+        void notify();
+        void notifyAll();
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<unsigned> waiting{};
+    };
+
+    bool tryPushItem(T &item);
+    bool tryPopItem(T &item);
+    bool slotFree();
+    bool itemAvailable();
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask{};
+
+    alignas(64) std::atomic<size_t> pushPosition{};
+    alignas(64) std::atomic<size_t> popPosition{};
+    std::atomic<bool> aborted{};
+
+    Parking pushParking;
+    Parking popParking;
+};
+
+} // namespace vca
@@ -49,38 +49,28 @@ void MultiThreadQueue<T>::waitAndPush(T item)
 }
 
 template<class T>
-void MultiThreadQueue<T>::waitAndPushInOrder(T item, size_t orderCounter)
+std::optional<T> MultiThreadQueue<T>::waitAndPop()
 {
-    if (this->aborted)
-        return;
-
     std::unique_lock<std::mutex> lock(this->accessMutex);
-    this->popJobCV.wait(lock, [this, orderCounter]() {
-        if (this->aborted)
-            return true;
-        auto slotFree = this->maximumQueueSize == 0 || this->items.size() < this->maximumQueueSize;
-        return slotFree && orderCounter == this->pushCounter;
-    });
+    this->pushJobCV.wait(lock, [this]() { return !this->items.empty() || this->aborted; });
 
     if (this->aborted)
-        return;
+        return {};
 
-    this->items.push(std::move(item));
-    this->pushCounter++;
-    this->popJobCV.notify_all();
-    this->pushJobCV.notify_one();
+    auto item = this->items.front();
+    this->items.pop();
+    this->popJobCV.notify_one();
+    return item;
 }
 
 template<class T>
-std::optional<T> MultiThreadQueue<T>::waitAndPop()
+std::optional<T> MultiThreadQueue<T>::tryPop()
 {
     std::unique_lock<std::mutex> lock(this->accessMutex);
-    this->pushJobCV.wait(lock, [this]() { return !this->items.empty() || this->aborted; });
-
-    if (this->aborted)
+    if (this->aborted || this->items.empty())
         return {};
 
-    auto item = this->items.front();
+    auto item = std::move(this->items.front());
     this->items.pop();
     this->popJobCV.notify_one();
     return item;
@@ -96,6 +86,13 @@ bool MultiThreadQueue<T>::empty()
     return this->items.empty();
 }
 
+template<class T>
+size_t MultiThreadQueue<T>::size()
+{
+    std::unique_lock<std::mutex> lock(this->accessMutex);
+    return this->items.size();
+}
+
 template<class T>
 void MultiThreadQueue<T>::setMaximumQueueSize(size_t max)
 {
@@ -103,6 +100,6 @@ void MultiThreadQueue<T>::setMaximumQueueSize(size_t max)
 }
 
 template class MultiThreadQueue<Job>;
-template class MultiThreadQueue<Result>;
+template class MultiThreadQueue<std::shared_ptr<SharedResult>>;
 
 } // namespace vca
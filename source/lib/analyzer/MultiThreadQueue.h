@@ -32,17 +32,16 @@ public:
     // Push an item to the queue. Wait if the queue reached a maximum size.
     // Wake one waiting thread.
     void waitAndPush(T item);
-    // Push items in order. Increase the counter by one in the order of items.
-    // Pushing threads will be paused until the pushs are in order.
-    // Don't mix calls to these two push functions.
-    void waitAndPushInOrder(T item, size_t counter);
 
     // Get an item. If the queue is empty, wait until an item is pushed.
     // Will return empty opt if abort is called.
     std::optional<T> waitAndPop();
+    // Get an item if there is one. Never waits.
+    std::optional<T> tryPop();
 
     void abort();
     bool empty();
+    size_t size();
 
     // If the queue is fuller then this limit, the push function will wait until
     // there is enought space. 0 means no limit.
@@ -56,7 +55,6 @@ private:
 
     bool aborted{};
     size_t maximumQueueSize{};
-    size_t pushCounter{};
 };
 
 } // namespace vca
@@ -0,0 +1,159 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "Primitives.h"
+
+#include "EnergyCalculation.h"
+#include "common.h"
+#include "simd/dct-avx2.h"
+#include "simd/dct-avx512.h"
+#include "simd/dct-sse2.h"
+#include "simd/dct-ssse3.h"
+#include "simd/dct8.h"
+#include "simd/energy.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using namespace vca;
+
+uint32_t weightedCoeffSum_c(const int16_t *coeff, const uint16_t *weights, intptr_t count)
+{
+    uint32_t weightedSum = 0;
+    for (intptr_t i = 0; i < count; i++)
+        weightedSum += (uint32_t(weights[i]) * uint32_t(std::abs(coeff[i]))) >> 16;
+    return weightedSum;
+}
+
+void setupCPrimitives(EnergyPrimitives &p)
+{
+    p.block8.weights          = getWeightFactorMatrix(8);
+    p.block16.weights         = getWeightFactorMatrix(16);
+    p.block32.weights         = getWeightFactorMatrix(32);
+    p.block8.dct              = dct8_c;
+    p.block8.dct_u8           = dct8_u8_c;
+    p.block8.dct_u16          = dct8_u16_c;
+    p.block8.dct_u16_generic  = dct8_u16_c;
+    p.block16.dct             = dct16_c;
+    p.block16.dct_u8          = dct16_u8_c;
+    p.block16.dct_u16         = dct16_u16_c;
+    p.block16.dct_u16_generic = dct16_u16_c;
+    p.block32.dct             = dct32_c;
+    p.block32.dct_u8          = dct32_u8_c;
+    p.block32.dct_u16         = dct32_u16_c;
+    p.block32.dct_u16_generic = dct32_u16_c;
+    p.weightedSum             = weightedCoeffSum_c;
+}
+
+// Each level only overwrites the entries for which it has a faster kernel than the levels
+// below it. So every entry ends up with the best kernel at or below the selected level.
+// The assembly kernels only exist for int16_t input. They are only used for the padded border
+// blocks. The blocks read directly from the frame always use the intrinsics kernels so that
+// the samples are not copied to an int16_t buffer first.
+void setupSimdPrimitives(EnergyPrimitives &p, CpuSimd cpuSimd)
+{
+    if (cpuSimd >= CpuSimd::SSE2)
+    {
+#if ENABLE_NASM
+        p.block8.dct = vca_dct8_sse2;
+#else
+        p.block8.dct = vca_dct8_intrin_sse2;
+#endif
+        p.block8.dct_u8  = vca_dct8_u8_sse2;
+        p.block8.dct_u16 = vca_dct8_u16_sse2;
+    }
+    if (cpuSimd >= CpuSimd::SSSE3)
+    {
+        p.block16.dct     = vca_dct16_ssse3;
+        p.block16.dct_u8  = vca_dct16_u8_ssse3;
+        p.block16.dct_u16 = vca_dct16_u16_ssse3;
+        p.block32.dct     = vca_dct32_ssse3;
+        p.block32.dct_u8  = vca_dct32_u8_ssse3;
+        p.block32.dct_u16 = vca_dct32_u16_ssse3;
+        p.weightedSum     = vca_weighted_coeff_sum_ssse3;
+    }
+#if ENABLE_NASM
+    if (cpuSimd >= CpuSimd::SSE4)
+        p.block8.dct = vca_dct8_sse4;
+#endif
+    if (cpuSimd >= CpuSimd::AVX2)
+    {
+#if ENABLE_NASM
+        p.block8.dct  = vca_dct8_avx2;
+        p.block16.dct = vca_dct16_avx2;
+        p.block32.dct = vca_dct32_avx2;
+#else
+        p.block8.dct  = vca_dct8_intrin_avx2;
+        p.block16.dct = vca_dct16_intrin_avx2;
+        p.block32.dct = vca_dct32_intrin_avx2;
+#endif
+        p.block8.dct_u8   = vca_dct8_u8_avx2;
+        p.block16.dct_u8  = vca_dct16_u8_avx2;
+        p.block32.dct_u8  = vca_dct32_u8_avx2;
+        p.block8.dct_u16  = vca_dct8_u16_avx2;
+        p.block16.dct_u16 = vca_dct16_u16_avx2;
+        p.block32.dct_u16 = vca_dct32_u16_avx2;
+        p.weightedSum     = vca_weighted_coeff_sum_avx2;
+        p.energy8x4_u8    = vca_dct8_energy4_u8_avx2;
+        p.energy8x4_u16   = vca_dct8_energy4_u16_avx2;
+    }
+    if (cpuSimd >= CpuSimd::AVX512)
+    {
+        p.block8.dct      = vca_dct8_avx512;
+        p.block8.dct_u8   = vca_dct8_u8_avx512;
+        p.block8.dct_u16  = vca_dct8_u16_avx512;
+        p.block16.dct     = vca_dct16_avx512;
+        p.block16.dct_u8  = vca_dct16_u8_avx512;
+        p.block16.dct_u16 = vca_dct16_u16_avx512;
+        p.block32.dct     = vca_dct32_avx512;
+        p.block32.dct_u8  = vca_dct32_u8_avx512;
+        p.block32.dct_u16 = vca_dct32_u16_avx512;
+        p.weightedSum     = vca_weighted_coeff_sum_avx512;
+    }
+}
+
+} // namespace
+
+namespace vca {
+
+const BlockPrimitives &EnergyPrimitives::get(unsigned blockSize) const
+{
+    switch (blockSize)
+    {
+        case 8:
+            return this->block8;
+        case 16:
+            return this->block16;
+        case 32:
+            return this->block32;
+        default:
+            throw std::invalid_argument("Invalid block size " + std::to_string(blockSize));
+    }
+}
+
+void setupEnergyPrimitives(EnergyPrimitives &primitives, CpuSimd cpuSimd)
+{
+    setupCPrimitives(primitives);
+    setupSimdPrimitives(primitives, cpuSimd);
+}
+
+} // namespace vca
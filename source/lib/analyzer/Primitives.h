@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include "DCTTransforms.h"
+#include "vcaLib.h"
+
+namespace vca {
+
+typedef uint32_t (*weighted_sum_t)(const int16_t *coeff, const uint16_t *weights, intptr_t count);
+typedef void (*energy8x4_u8_t)(const uint8_t *src,
+                               intptr_t srcStride,
+                               const uint16_t *weights,
+                               uint32_t *energies);
+typedef void (*energy8x4_u16_t)(const uint16_t *src,
+                                intptr_t srcStride,
+                                const uint16_t *weights,
+                                uint32_t *energies,
+                                unsigned bitDepth);
+
+// The transforms and the coefficient weights of one block size
+struct BlockPrimitives
+{
+    // The weights for the weighted sum of the transformed block
+    const uint16_t *weights{};
+    // Transform of a block of int16_t values. Used for the padded blocks at the frame border.
+    dct_t dct{};
+    // Transform of 8 bit samples read directly from the frame
+    dct_u8_t dct_u8{};
+    // Transform of 10 or 12 bit samples read directly from the frame
+    dct_u16_t dct_u16{};
+    // Transform of samples with any other high bit depth
+    dct_u16_t dct_u16_generic{};
+};
+
+// The kernels of the energy calculation. Each entry is the fastest kernel that is available
+// at or below the SIMD level the table was set up for. The table is set up once when the
+// analyzer is opened so that no kernel has to be selected per block.
+struct EnergyPrimitives
+{
+    BlockPrimitives block8;
+    BlockPrimitives block16;
+    BlockPrimitives block32;
+    weighted_sum_t weightedSum{};
+    // Transform and weighted sum of 4 horizontally adjacent 8x8 blocks read directly from the
+    // frame. These are only set if the SIMD level has such a kernel. Otherwise the blocks are
+    // processed one by one. The u16 kernel supports 10 and 12 bit.
+    energy8x4_u8_t energy8x4_u8{};
+    energy8x4_u16_t energy8x4_u16{};
+
+    const BlockPrimitives &get(unsigned blockSize) const;
+};
+
+void setupEnergyPrimitives(EnergyPrimitives &primitives, CpuSimd cpuSimd);
+
+} // namespace vca
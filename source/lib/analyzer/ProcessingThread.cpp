@@ -23,12 +23,14 @@
 namespace vca {
 
 ProcessingThread::ProcessingThread(vca_param cfg,
-                                   MultiThreadQueue<Job> &jobs,
-                                   MultiThreadQueue<Result> &results,
+                                   const EnergyPrimitives &primitives,
+                                   JobQueue &jobs,
+                                   ResultQueue &results,
                                    unsigned id)
 {
-    this->cfg = cfg;
-    this->id  = id;
+    this->cfg        = cfg;
+    this->primitives = primitives;
+    this->id         = id;
 
     this->thread = std::thread(&ProcessingThread::threadFunction,
                                this,
@@ -36,34 +38,93 @@ ProcessingThread::ProcessingThread(vca_param cfg,
                                std::ref(results));
 }
 
-void ProcessingThread::threadFunction(MultiThreadQueue<Job> &jobQueue,
-                                      MultiThreadQueue<Result> &results)
+void ProcessingThread::threadFunction(JobQueue &jobQueue, ResultQueue &results)
 {
+    const auto enableStats = this->cfg.enableStats;
     while (!this->aborted)
     {
-        auto job = jobQueue.waitAndPop();
+        auto waitStartTicks = enableStats ? readTicks() : 0;
+        auto job            = jobQueue.waitAndPop();
         if (!job)
             break;
 
+        JobTicks jobTicks;
+        uint64_t jobStartTicks{};
+        if (enableStats)
+        {
+            jobStartTicks = readTicks();
+            addTicks(this->stats.idleTicks, jobStartTicks - waitStartTicks);
+        }
+
         log(this->cfg,
             LogLevel::Debug,
             "Thread " + std::to_string(this->id) + ": Start work on job " + job->infoString());
 
-        Result result;
-        result.poc = job->frame->stats.poc;
-        result.jobID = job->jobID;
-        computeWeightedDCTEnergy(*job, result, this->cfg.blockSize, this->cfg.cpuSimd);
+        auto &sharedResult = *job->sharedResult;
+        auto sliceTexture  = computeWeightedDCTEnergy(*job,
+                                                      sharedResult.result,
+                                                      this->cfg.blockSize,
+                                                      this->primitives,
+                                                      enableStats ? &jobTicks : nullptr);
+        sharedResult.frameTexture += sliceTexture;
 
         log(this->cfg,
             LogLevel::Debug,
             "Thread " + std::to_string(this->id) + ": Finished work on job " + job->infoString());
 
-        results.waitAndPushInOrder(result, result.jobID);
+        if (--sharedResult.slicesPending == 0)
+        {
+            computeAverageEnergy(sharedResult.result, sharedResult.frameTexture);
+
+            if (--sharedResult.dependenciesPending == 0)
+            {
+                auto frame = job->sharedResult;
+                while (frame)
+                    frame = this->completeFrame(std::move(frame), results);
+            }
+        }
+
+        if (enableStats)
+        {
+            addTicks(this->stats.copyTicks, jobTicks.copy);
+            addTicks(this->stats.transformTicks, jobTicks.transform);
+            addTicks(this->stats.weightedSumTicks, jobTicks.weightedSum);
+            addTicks(this->stats.busyTicks, readTicks() - jobStartTicks);
+            addTicks(this->stats.jobs, 1);
+        }
     }
 
     log(this->cfg, LogLevel::Debug, "Thread " + std::to_string(this->id) + " quit");
 }
 
+// Calculate the SAD and epsilon of the frame and push the result. Returns the next frame if it
+// can be completed now.
+std::shared_ptr<SharedResult> ProcessingThread::completeFrame(std::shared_ptr<SharedResult> frame,
+                                                             ResultQueue &results)
+{
+    if (frame->previous)
+    {
+        auto startTicks = this->cfg.enableStats ? readTicks() : 0;
+        computeTextureSAD(frame->result, frame->previous->result);
+        computeEpsilon(frame->result, frame->previous->result);
+        if (this->cfg.enableStats)
+            addTicks(this->stats.sadTicks, readTicks() - startTicks);
+        frame->previous.reset();
+    }
+    else
+        frame->result.sadPerBlock.assign(frame->result.energyPerBlock.size(), 0);
+
+    results.waitAndPush(frame);
+
+    if (frame->linkState++ == 0)
+        return {};
+
+    auto next = frame->next.lock();
+    if (!next || --next->dependenciesPending > 0)
+        return {};
+    return next;
+}
+
 void ProcessingThread::abort()
 {
     this->aborted = true;
@@ -20,7 +20,9 @@
 
 #include "vcaLib.h"
 
-#include "MultiThreadQueue.h"
+#include "Primitives.h"
+#include "Stats.h"
+#include "WorkQueue.h"
 #include "common.h"
 #include <thread>
 
@@ -32,21 +34,30 @@ public:
     ProcessingThread()                     = delete;
     ProcessingThread(ProcessingThread &&o) = delete;
     ProcessingThread(vca_param cfg,
-                     MultiThreadQueue<Job> &jobs,
-                     MultiThreadQueue<Result> &results,
+                     const EnergyPrimitives &primitives,
+                     JobQueue &jobs,
+                     ResultQueue &results,
                      unsigned id);
     ~ProcessingThread() = default;
 
     void abort();
     void join();
 
+    const ThreadStats &getStats() const { return this->stats; }
+
 private:
-    void threadFunction(MultiThreadQueue<Job> &jobQueue, MultiThreadQueue<Result> &results);
+    void threadFunction(JobQueue &jobQueue, ResultQueue &results);
+    std::shared_ptr<SharedResult> completeFrame(std::shared_ptr<SharedResult> frame,
+                                                ResultQueue &results);
 
     std::thread thread;
     bool aborted{};
     unsigned id{};
     vca_param cfg;
+    EnergyPrimitives primitives;
+
+    // Only updated if enableStats is set
+    ThreadStats stats;
 };
 
 } // namespace vca
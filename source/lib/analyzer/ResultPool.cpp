@@ -0,0 +1,71 @@
+/* Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "ResultPool.h"
+
+namespace vca {
+
+ResultPool::~ResultPool()
+{
+    for (auto result : this->freeResults)
+        delete result;
+}
+
+std::shared_ptr<SharedResult> ResultPool::get(size_t numberBlocks)
+{
+    SharedResult *sharedResult = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(this->accessMutex);
+        if (!this->freeResults.empty())
+        {
+            sharedResult = this->freeResults.back();
+            this->freeResults.pop_back();
+        }
+    }
+    if (sharedResult == nullptr)
+        sharedResult = new SharedResult();
+
+    auto &result         = sharedResult->result;
+    result.averageEnergy = 0;
+    result.sad           = 0.0;
+    result.epsilon       = 0.0;
+    result.energyPerBlock.resize(numberBlocks);
+    result.sadPerBlock.resize(numberBlocks);
+
+    sharedResult->frameTexture        = 0;
+    sharedResult->dependenciesPending = 0;
+    sharedResult->linkState           = 0;
+    sharedResult->borrowedResult      = {};
+
+    auto pool = this->shared_from_this();
+    return std::shared_ptr<SharedResult>(sharedResult,
+                                         [pool](SharedResult *result) { pool->recycle(result); });
+}
+
+void ResultPool::recycle(SharedResult *result)
+{
+    // The links to other frames hold references to the pool. Drop them so that the pool can be
+    // freed once all results are back.
+    result->previous.reset();
+    result->next.reset();
+
+    std::unique_lock<std::mutex> lock(this->accessMutex);
+    this->freeResults.push_back(result);
+}
+
+} // namespace vca
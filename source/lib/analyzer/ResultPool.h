@@ -0,0 +1,48 @@
+/* Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vca {
+
+// Keeps the results of frames that were handed out before so that their buffers can be reused.
+// A result is put back into the pool automatically once the last reference to it is dropped.
+// The references hold a reference to the pool, so it stays alive until all results are gone.
+class ResultPool : public std::enable_shared_from_this<ResultPool>
+{
+public:
+    ~ResultPool();
+
+    // Get a result where the per block vectors are sized to hold numberBlocks values.
+    // All other values are reset.
+    std::shared_ptr<SharedResult> get(size_t numberBlocks);
+
+private:
+    void recycle(SharedResult *result);
+
+    std::mutex accessMutex;
+    std::vector<SharedResult *> freeResults;
+};
+
+} // namespace vca
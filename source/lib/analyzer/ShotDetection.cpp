@@ -111,4 +111,68 @@ vca_result shot_detection(const vca_shot_detection_param &param,
     return vca_result::VCA_OK;
 }
 
+ShotDetector::ShotDetector(const vca_shot_detection_param &param)
+{
+    this->param = param;
+}
+
+void ShotDetector::push(double epsilon)
+{
+    const auto index = this->frameCounter++;
+
+    vca_shot_detect_frame frame;
+    frame.epsilon   = epsilon;
+    frame.isNewShot = (index == 0);
+    this->frames.push_back(frame);
+
+    if (index >= 2 && epsilon > this->param.maxEpsilonThresh)
+    {
+        this->frames.back().isNewShot = true;
+        this->previousShotPosition    = index;
+    }
+    else if (index >= 2 && epsilon >= this->param.minEpsilonThresh)
+    {
+        // An unsure frame is a new shot if it and the next unsure frame are both more than
+        // fps frames away from the last certain shot.
+        const auto previousShotDistance = index - this->previousShotPosition;
+        if (this->unsureFrameIndex)
+            this->decideUnsureFrame(this->unsureFrameDistance > this->param.fps
+                                    && previousShotDistance > this->param.fps);
+
+        if (previousShotDistance > this->param.fps)
+        {
+            this->unsureFrameIndex    = index;
+            this->unsureFrameDistance = previousShotDistance;
+        }
+    }
+
+    if (this->param.maxLookahead > 0 && this->unsureFrameIndex
+        && index - *this->unsureFrameIndex >= this->param.maxLookahead)
+        this->decideUnsureFrame(false);
+}
+
+void ShotDetector::decideUnsureFrame(bool isNewShot)
+{
+    this->frames[*this->unsureFrameIndex - this->firstFrameIndex].isNewShot = isNewShot;
+    this->unsureFrameIndex.reset();
+}
+
+std::optional<vca_shot_detect_frame> ShotDetector::pop()
+{
+    if (this->frames.empty() || this->unsureFrameIndex == this->firstFrameIndex)
+        return {};
+
+    auto frame = this->frames.front();
+    this->frames.pop_front();
+    this->firstFrameIndex++;
+    return frame;
+}
+
+void ShotDetector::flush()
+{
+    // There is no next unsure frame
+    if (this->unsureFrameIndex)
+        this->decideUnsureFrame(false);
+}
+
 } // namespace vca
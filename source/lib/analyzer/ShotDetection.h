@@ -20,10 +20,44 @@
 
 #include "vcaLib.h"
 
+#include <deque>
+#include <optional>
+
 namespace vca {
 
 vca_result shot_detection(const vca_shot_detection_param &param,
                           vca_shot_detect_frame *frames,
                           size_t num_frames);
 
-}
+// Makes the same decisions as shot_detection but frame by frame. A frame with an epsilon
+// between the two thresholds can only be decided once the next such frame was pushed. Until then,
+// this frame and all frames after it are held back.
+class ShotDetector
+{
+public:
+    ShotDetector(const vca_shot_detection_param &param);
+
+    void push(double epsilon);
+    // Get the next frame if it is decided
+    std::optional<vca_shot_detect_frame> pop();
+    // No more frames will be pushed. Decide all frames.
+    void flush();
+
+private:
+    void decideUnsureFrame(bool isNewShot);
+
+    vca_shot_detection_param param;
+
+    size_t frameCounter{};
+    size_t previousShotPosition{};
+
+    // All frames that were pushed but not popped yet
+    std::deque<vca_shot_detect_frame> frames;
+    size_t firstFrameIndex{};
+
+    // There is at most one frame that is not decided yet
+    std::optional<size_t> unsureFrameIndex;
+    size_t unsureFrameDistance{};
+};
+
+} // namespace vca
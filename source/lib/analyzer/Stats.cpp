@@ -0,0 +1,52 @@
+/* Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+
+#include "Stats.h"
+
+#include <chrono>
+
+namespace {
+
+int64_t steadyClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+namespace vca {
+
+TickConverter::TickConverter()
+{
+    this->startNs    = steadyClockNs();
+    this->startTicks = readTicks();
+}
+
+uint64_t TickConverter::toNanoseconds(uint64_t ticks) const
+{
+    auto elapsedNs    = steadyClockNs() - this->startNs;
+    auto elapsedTicks = readTicks() - this->startTicks;
+    if (elapsedTicks == 0)
+        return 0;
+    return uint64_t(double(ticks) * double(elapsedNs) / double(elapsedTicks));
+}
+
+} // namespace vca
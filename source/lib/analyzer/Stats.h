@@ -0,0 +1,93 @@
+/* Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+namespace vca {
+
+// The timing counters are only collected if enableStats is set. Reading the time stamp counter
+// is much cheaper than reading a clock, so all counters are kept in ticks and only converted to
+// nanoseconds when they are read.
+inline uint64_t readTicks()
+{
+    return __rdtsc();
+}
+
+// Converts ticks to nanoseconds by comparing the ticks and the steady clock since construction
+class TickConverter
+{
+public:
+    TickConverter();
+
+    uint64_t toNanoseconds(uint64_t ticks) const;
+
+private:
+    int64_t startNs{};
+    uint64_t startTicks{};
+};
+
+// The time that one job spent in the stages of the energy calculation
+struct JobTicks
+{
+    uint64_t copy{};
+    uint64_t transform{};
+    uint64_t weightedSum{};
+};
+
+// Counters of one worker thread. They are only written by the thread itself but may be read at
+// any time.
+struct ThreadStats
+{
+    std::atomic<uint64_t> copyTicks{};
+    std::atomic<uint64_t> transformTicks{};
+    std::atomic<uint64_t> weightedSumTicks{};
+    std::atomic<uint64_t> sadTicks{};
+    std::atomic<uint64_t> busyTicks{};
+    std::atomic<uint64_t> idleTicks{};
+    std::atomic<uint64_t> jobs{};
+};
+
+// Counters of the calls to the analyzer from the application
+struct AnalyzerStats
+{
+    std::atomic<uint64_t> frames{};
+    std::atomic<uint64_t> pushWaitTicks{};
+    std::atomic<uint64_t> pullWaitTicks{};
+    std::atomic<uint64_t> pullCopyTicks{};
+
+    // The depth of the job queue is sampled whenever a job is pushed
+    std::atomic<uint64_t> jobQueueDepthSum{};
+    std::atomic<uint64_t> jobQueueDepthSamples{};
+    std::atomic<uint64_t> maxJobQueueDepth{};
+};
+
+inline void addTicks(std::atomic<uint64_t> &counter, uint64_t ticks)
+{
+    counter.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+} // namespace vca
@@ -0,0 +1,45 @@
+/* Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include "LockFreeQueue.h"
+#include "MultiThreadQueue.h"
+#include "common.h"
+
+namespace vca {
+
+// The queue type used to pass the jobs from the analyzer to the worker threads. Both queues are
+// always built. The lock free queue is the default. The mutex based queue can be selected by
+// turning ENABLE_LOCKFREE_QUEUE off.
+#if defined(VCA_LOCKFREE_QUEUE)
+template<class T>
+using WorkQueue = LockFreeQueue<T>;
+#else
+template<class T>
+using WorkQueue = MultiThreadQueue<T>;
+#endif
+
+// The results always use the unbounded MultiThreadQueue. The lock free queue has a fixed size
+// and the application may push any number of frames before it pulls the first result. If the
+// workers blocked on a full result queue, the job queue would fill up and
+// vca_analyzer_push would never return.
+using JobQueue    = WorkQueue<Job>;
+using ResultQueue = MultiThreadQueue<std::shared_ptr<SharedResult>>;
+
+} // namespace vca
@@ -20,6 +20,8 @@
 
 #include "vcaLib.h"
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -29,8 +31,10 @@ namespace vca {
 
 #if defined(__GNUC__)
 #define ALIGN_VAR_32(T, var) T var __attribute__((aligned(32)))
+#define ALIGN_VAR_64(T, var) T var __attribute__((aligned(64)))
 #elif defined(_MSC_VER)
 #define ALIGN_VAR_32(T, var) __declspec(align(32)) T var
+#define ALIGN_VAR_64(T, var) __declspec(align(64)) T var
 #endif
 
 inline void log(const vca_param &cfg, LogLevel level, const std::string &message)
@@ -49,17 +53,33 @@ inline std::pair<unsigned, unsigned> getFrameSizeInBlocks(unsigned blockSize,
     return {widthInBlocks, heightInBlock};
 }
 
+// A range of block rows [start, end) of a frame.
 struct MacroblockRange
 {
     unsigned start{};
     unsigned end{};
 };
 
+struct SharedResult;
+struct Job;
+struct Result;
+struct EnergyPrimitives;
+struct JobTicks;
+
+// The energy calculation of one slice specialized for the block size and bit depth of the frames
+typedef uint32_t (*energy_slice_t)(const Job &job,
+                                   Result &result,
+                                   const EnergyPrimitives &primitives,
+                                   JobTicks *ticks);
+
 struct Job
 {
     vca_frame *frame;
     MacroblockRange macroblockRange;
     unsigned jobID;
+    std::shared_ptr<SharedResult> sharedResult;
+    // Selected by the analyzer once the first frame fixed the bit depth
+    energy_slice_t computeEnergySlice;
 
     std::string infoString()
     {
@@ -80,4 +100,27 @@ struct Result
     unsigned jobID{};
 };
 
+// If a frame is split into slices, the jobs of all slices write into the same result.
+// The job that finishes the last slice completes the energy of the frame.
+// The SAD and epsilon of a frame need the previous frame, so the frames are completed in order.
+// A frame is completed by whoever finishes last: The job that finishes its energy or the thread
+// that completed the previous frame.
+struct SharedResult
+{
+    Result result;
+    std::atomic<unsigned> slicesPending{};
+    std::atomic<uint32_t> frameTexture{};
+
+    std::shared_ptr<SharedResult> previous;
+    std::weak_ptr<SharedResult> next;
+    // The energy of this frame and the completion of the previous frame
+    std::atomic<unsigned> dependenciesPending{};
+    // Incremented when the next frame is linked and when this frame is completed.
+    // Whoever increments it second passes the completion on to the next frame.
+    std::atomic<unsigned> linkState{};
+
+    // What is handed out if the result is borrowed. Points to the data of result.
+    vca_borrowed_frame_results borrowedResult{};
+};
+
 } // namespace vca
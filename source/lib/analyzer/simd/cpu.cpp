@@ -32,6 +32,13 @@
 #include <sys/param.h>
 #include <sys/sysctl.h>
 
+#endif
+#if VCA_ARCH_X86 && !ENABLE_NASM
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
 #endif
 
 namespace vca {
@@ -92,6 +99,33 @@ int vca_cpu_cpuid_test(void);
 void vca_cpu_cpuid(uint32_t op, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx);
 uint64_t vca_cpu_xgetbv(int xcr);
 }
+#else
+// Without NASM the same queries are done using the compiler intrinsics
+static void vca_cpu_cpuid(uint32_t op, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuidex(regs, int(op), 0);
+    *eax = uint32_t(regs[0]);
+    *ebx = uint32_t(regs[1]);
+    *ecx = uint32_t(regs[2]);
+    *edx = uint32_t(regs[3]);
+#else
+    __cpuid_count(op, 0, *eax, *ebx, *ecx, *edx);
+#endif
+}
+
+static uint64_t vca_cpu_xgetbv(int xcr)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(uint32_t(xcr));
+#else
+    // The _xgetbv intrinsic of GCC requires compiling with -mxsave
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+    return (uint64_t(edx) << 32) | eax;
+#endif
+}
 #endif
 
 #if defined(_MSC_VER)
@@ -101,13 +135,12 @@ uint64_t vca_cpu_xgetbv(int xcr);
 CpuSimd cpuDetectMaxSimd()
 {
     auto cpu = CpuSimd::SSSE3;
-#if ENABLE_NASM
     uint32_t eax, ebx, ecx, edx;
     uint32_t vendor[4] = {0};
     uint32_t max_basic_cap;
     uint64_t xcr0 = 0;
 
-#if !X86_64
+#if ENABLE_NASM && !X86_64
     if (!vca_cpu_cpuid_test())
         return 0;
 #endif
@@ -137,8 +170,13 @@ CpuSimd cpuDetectMaxSimd()
             if (ebx & 0x00000020)
                 cpu = CpuSimd::AVX2;
         }
+        if ((xcr0 & 0xE6) == 0xE6) /* XMM/YMM/ZMM state */
+        {
+            /* The AVX-512 kernels need the F, BW and VL subsets */
+            if ((ebx & 0xC0010000) == 0xC0010000)
+                cpu = CpuSimd::AVX512;
+        }
     }
-#endif
     return cpu;
 }
 
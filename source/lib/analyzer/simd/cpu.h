@@ -26,6 +26,7 @@
 #define VCA_CPU_SSSE3  (1 << 1)
 #define VCA_CPU_SSE4   (1 << 2)
 #define VCA_CPU_AVX2   (1 << 3)
+#define VCA_CPU_AVX512 (1 << 4)
 
 // from primitives.cpp
 #if ENABLE_NASM
@@ -0,0 +1,366 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "dct-avx2.h"
+#include "dct-tables.h"
+
+#include <analyzer/common.h>
+
+#include <immintrin.h> // AVX2
+
+// The same two matrix multiplications as in the AVX-512 kernels but without the word and
+// dword permutes that AVX2 lacks.
+//  - The first stage splits each row into even and odd parts (E/O) in 128 bit halves. The pair
+//    p of E and of O is broadcast to all lanes so that the even output lanes use the E pair and
+//    the odd lanes the O pair. These 16 bit sums do not overflow for up to 12 bit input.
+//  - The second stage operates on the columns of the intermediate block. The rows (2q, 2q + 1)
+//    are interleaved within the 128 bit lanes. packs_epi32 reverts this interleaving so that the
+//    results are stored in natural order.
+
+#define DCT_SHIFT1(N) (((N) == 8 ? 2 : (N) == 16 ? 3 : 4) + bitDepth - 8)
+#define DCT_SHIFT2(N) ((N) == 8 ? 9 : (N) == 16 ? 10 : 11)
+
+namespace {
+
+using namespace vca::dct_tables;
+
+ALIGN_VAR_32(constexpr auto, tab_dct8_1)  = makeFirstStageTable<8>();
+ALIGN_VAR_32(constexpr auto, tab_dct16_1) = makeFirstStageTable<16>();
+ALIGN_VAR_32(constexpr auto, tab_dct32_1) = makeFirstStageTable<32>();
+ALIGN_VAR_32(constexpr auto, tab_dct8_2)  = makeSecondStageTable<8>();
+ALIGN_VAR_32(constexpr auto, tab_dct16_2) = makeSecondStageTable<16>();
+ALIGN_VAR_32(constexpr auto, tab_dct32_2) = makeSecondStageTable<32>();
+
+template<int N> constexpr const FirstStageTable<N> &firstStageTable()
+{
+    if constexpr (N == 8)
+        return tab_dct8_1;
+    else if constexpr (N == 16)
+        return tab_dct16_1;
+    else
+        return tab_dct32_1;
+}
+
+template<int N> constexpr const SecondStageTable<N> &secondStageTable()
+{
+    if constexpr (N == 8)
+        return tab_dct8_2;
+    else if constexpr (N == 16)
+        return tab_dct16_2;
+    else
+        return tab_dct32_2;
+}
+
+template<int shift> inline __m256i roundAndShift(__m256i sum)
+{
+    return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(1 << (shift - 1))), shift);
+}
+
+// Pack two registers of 32 bit sums to 16 values in the order a0..a7, b0..b7
+inline __m256i packTwo(__m256i a, __m256i b)
+{
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+// Load 8 samples of a row. 8 bit samples are widened to 16 bit while loading.
+inline __m128i loadPixels(const int16_t *src)
+{
+    return _mm_loadu_si128((const __m128i *) src);
+}
+
+inline __m128i loadPixels(const uint16_t *src)
+{
+    return _mm_loadu_si128((const __m128i *) src);
+}
+
+inline __m128i loadPixels(const uint8_t *src)
+{
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *) src));
+}
+
+inline __m128i reverseWords(__m128i value)
+{
+    const __m128i reverse = _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+    return _mm_shuffle_epi8(value, reverse);
+}
+
+// First stage of one row. Sum h holds the outputs k = 8h to 8h + 7 as 32 bit values.
+template<int N, typename PixelType>
+inline void firstStageRow(const PixelType *src, __m256i (&sum)[N / 8])
+{
+    const auto &table = firstStageTable<N>();
+
+    // E[n] = src[n] + src[N - 1 - n] and O[n] = src[n] - src[N - 1 - n] for n < N / 2 in
+    // registers of 8 values. For 8x8 only the lower 4 values are used.
+    constexpr int nrHalves = N == 8 ? 1 : N / 16;
+    __m128i E[nrHalves];
+    __m128i O[nrHalves];
+    if constexpr (N == 8)
+    {
+        const auto row = loadPixels(src);
+        const auto rev = reverseWords(row);
+        E[0]           = _mm_add_epi16(row, rev);
+        O[0]           = _mm_sub_epi16(row, rev);
+    }
+    else
+    {
+        for (int i = 0; i < nrHalves; i++)
+        {
+            const auto row = loadPixels(&src[8 * i]);
+            const auto rev = reverseWords(loadPixels(&src[N - 8 - 8 * i]));
+            E[i]           = _mm_add_epi16(row, rev);
+            O[i]           = _mm_sub_epi16(row, rev);
+        }
+    }
+
+    for (int h = 0; h < N / 8; h++)
+        sum[h] = _mm256_setzero_si256();
+
+    for (int p = 0; p < N / 4; p++)
+    {
+        // The pair p is in dword (p % 4) of E[p / 4]. Select (E, O) pairs and broadcast them.
+        const auto i     = p / 4;
+        const auto eo    = (p % 4) < 2 ? _mm_unpacklo_epi32(E[i], O[i])
+                                       : _mm_unpackhi_epi32(E[i], O[i]);
+        const auto pairs = _mm256_broadcastq_epi64(p % 2 ? _mm_srli_si128(eo, 8) : eo);
+        for (int h = 0; h < N / 8; h++)
+        {
+            const auto coeff = _mm256_load_si256((const __m256i *) &table.pair[p][8 * h]);
+            sum[h]           = _mm256_add_epi32(sum[h], _mm256_madd_epi16(pairs, coeff));
+        }
+    }
+}
+
+// The 8x8 transform of one block. Register r receives the coefficient rows 2r and 2r + 1.
+template<int bitDepth, typename PixelType>
+inline void dct8Registers(const PixelType *src, intptr_t stride, __m256i (&coeff)[4])
+{
+    const auto &table = secondStageTable<8>();
+
+    // First stage: two rows are packed per register. packs_epi32 leaves the columns 0 to 3 of
+    // both rows in the lower lane and the columns 4 to 7 in the upper lane. Interleaving the
+    // two rows within the lanes gives the (2q, 2q + 1) pairs for the second stage.
+    const __m256i interleave = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15));
+    __m256i rowPairs[4];
+    for (int q = 0; q < 4; q++)
+    {
+        __m256i sumA[1], sumB[1];
+        firstStageRow<8>(&src[2 * q * stride], sumA);
+        firstStageRow<8>(&src[(2 * q + 1) * stride], sumB);
+        rowPairs[q] = _mm256_shuffle_epi8(_mm256_packs_epi32(roundAndShift<DCT_SHIFT1(8)>(sumA[0]),
+                                                             roundAndShift<DCT_SHIFT1(8)>(sumB[0])),
+                                          interleave);
+    }
+
+    // Second stage: the lower lane holds the columns 0 to 3 and the upper lane the columns 4 to 7
+    for (int k = 0; k < 8; k += 2)
+    {
+        __m256i sumA = _mm256_setzero_si256();
+        __m256i sumB = _mm256_setzero_si256();
+        for (int q = 0; q < 4; q++)
+        {
+            const auto coeffA = _mm256_set1_epi32(table.pair[k][q]);
+            const auto coeffB = _mm256_set1_epi32(table.pair[k + 1][q]);
+            sumA              = _mm256_add_epi32(sumA, _mm256_madd_epi16(rowPairs[q], coeffA));
+            sumB              = _mm256_add_epi32(sumB, _mm256_madd_epi16(rowPairs[q], coeffB));
+        }
+
+        coeff[k / 2] = packTwo(roundAndShift<DCT_SHIFT2(8)>(sumA),
+                               roundAndShift<DCT_SHIFT2(8)>(sumB));
+    }
+}
+
+template<int bitDepth, typename PixelType>
+void dct8(const PixelType *src, int16_t *dst, intptr_t stride)
+{
+    __m256i coeff[4];
+    dct8Registers<bitDepth>(src, stride, coeff);
+    for (int r = 0; r < 4; r++)
+        _mm256_storeu_si256((__m256i *) &dst[16 * r], coeff[r]);
+}
+
+// Transform and weight 4 horizontally adjacent 8x8 blocks. The coefficients stay in registers
+// and the weights are loaded once for all 4 blocks. The weighted sums are the same as the ones
+// of vca_weighted_coeff_sum_avx2.
+template<int bitDepth, typename PixelType>
+void dct8Energy4(const PixelType *src, intptr_t stride, const uint16_t *weights, uint32_t *energies)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    __m256i weightRegisters[4];
+    for (int r = 0; r < 4; r++)
+        weightRegisters[r] = _mm256_loadu_si256((const __m256i *) &weights[16 * r]);
+
+    __m256i sum[4];
+    for (int block = 0; block < 4; block++)
+    {
+        __m256i coeff[4];
+        dct8Registers<bitDepth>(&src[8 * block], stride, coeff);
+
+        __m256i weighted = _mm256_setzero_si256();
+        for (int r = 0; r < 4; r++)
+        {
+            // abs(-32768) is 0x8000 which is correct if interpreted as unsigned. The weights are
+            // scaled by 256 so the high half of the product is the weighted value.
+            const auto c       = _mm256_abs_epi16(coeff[r]);
+            const auto product = _mm256_mulhi_epu16(c, weightRegisters[r]);
+            weighted           = _mm256_add_epi32(weighted, _mm256_madd_epi16(product, ones));
+        }
+        sum[block] = weighted;
+    }
+
+    // Reduce the 4 sums at once. Afterwards dword b of each lane holds a part of block b.
+    const auto sum01 = _mm256_hadd_epi32(sum[0], sum[1]);
+    const auto sum23 = _mm256_hadd_epi32(sum[2], sum[3]);
+    const auto sums  = _mm256_hadd_epi32(sum01, sum23);
+    const auto low   = _mm256_castsi256_si128(sums);
+    const auto high  = _mm256_extracti128_si256(sums, 1);
+    _mm_storeu_si128((__m128i *) energies, _mm_add_epi32(low, high));
+}
+
+// The 16x16 and 32x32 transforms. Each row consists of N / 16 registers.
+template<int N, int bitDepth, typename PixelType>
+void dctLarge(const PixelType *src, int16_t *dst, intptr_t stride)
+{
+    constexpr int nrRegisters = N / 16;
+    const auto &table         = secondStageTable<N>();
+
+    ALIGN_VAR_32(int16_t, tmp[N * N]);
+
+    // First stage
+    for (int j = 0; j < N; j++)
+    {
+        __m256i sum[N / 8];
+        firstStageRow<N>(&src[j * stride], sum);
+        for (int r = 0; r < nrRegisters; r++)
+            _mm256_store_si256((__m256i *) &tmp[j * N + 16 * r],
+                               packTwo(roundAndShift<DCT_SHIFT1(N)>(sum[2 * r]),
+                                       roundAndShift<DCT_SHIFT1(N)>(sum[2 * r + 1])));
+    }
+
+    // Second stage: interleave the rows (2q, 2q + 1). The low part holds the columns 0 to 3 and
+    // 8 to 11 of each register and the high part the columns 4 to 7 and 12 to 15.
+    __m256i rowPairs[N / 2][2 * nrRegisters];
+    for (int q = 0; q < N / 2; q++)
+        for (int r = 0; r < nrRegisters; r++)
+        {
+            const auto *rows       = &tmp[2 * q * N + 16 * r];
+            const auto rowA        = _mm256_load_si256((const __m256i *) rows);
+            const auto rowB        = _mm256_load_si256((const __m256i *) (rows + N));
+            rowPairs[q][2 * r]     = _mm256_unpacklo_epi16(rowA, rowB);
+            rowPairs[q][2 * r + 1] = _mm256_unpackhi_epi16(rowA, rowB);
+        }
+
+    for (int k = 0; k < N; k++)
+    {
+        __m256i sum[2 * nrRegisters];
+        for (int r = 0; r < 2 * nrRegisters; r++)
+            sum[r] = _mm256_setzero_si256();
+
+        for (int q = 0; q < N / 2; q++)
+        {
+            const auto coeff = _mm256_set1_epi32(table.pair[k][q]);
+            for (int r = 0; r < 2 * nrRegisters; r++)
+                sum[r] = _mm256_add_epi32(sum[r], _mm256_madd_epi16(rowPairs[q][r], coeff));
+        }
+
+        // packs_epi32 of the low and the high part restores the order of the columns
+        for (int r = 0; r < nrRegisters; r++)
+            _mm256_storeu_si256((__m256i *) &dst[k * N + 16 * r],
+                                _mm256_packs_epi32(roundAndShift<DCT_SHIFT2(N)>(sum[2 * r]),
+                                                   roundAndShift<DCT_SHIFT2(N)>(sum[2 * r + 1])));
+    }
+}
+
+} // namespace
+
+void vca_dct8_intrin_avx2(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dct8<8>(src, dst, stride);
+}
+
+void vca_dct8_u8_avx2(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dct8<8>(src, dst, stride);
+}
+
+void vca_dct8_u16_avx2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct8<10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dct8<12>(src, dst, stride);
+}
+
+void vca_dct8_energy4_u8_avx2(const uint8_t *src,
+                              intptr_t stride,
+                              const uint16_t *weights,
+                              uint32_t *energies)
+{
+    dct8Energy4<8>(src, stride, weights, energies);
+}
+
+void vca_dct8_energy4_u16_avx2(const uint16_t *src,
+                               intptr_t stride,
+                               const uint16_t *weights,
+                               uint32_t *energies,
+                               unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct8Energy4<10>(src, stride, weights, energies);
+    else if (bitDepth == 12)
+        dct8Energy4<12>(src, stride, weights, energies);
+}
+
+void vca_dct16_intrin_avx2(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dctLarge<16, 8>(src, dst, stride);
+}
+
+void vca_dct16_u8_avx2(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dctLarge<16, 8>(src, dst, stride);
+}
+
+void vca_dct16_u16_avx2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dctLarge<16, 10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dctLarge<16, 12>(src, dst, stride);
+}
+
+void vca_dct32_intrin_avx2(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dctLarge<32, 8>(src, dst, stride);
+}
+
+void vca_dct32_u8_avx2(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dctLarge<32, 8>(src, dst, stride);
+}
+
+void vca_dct32_u16_avx2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dctLarge<32, 10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dctLarge<32, 12>(src, dst, stride);
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+// Intrinsics versions of the transforms. The assembly kernels of the same instruction set use
+// the plain names (see dct8.h) so these are called intrin. They are used in builds without NASM.
+void vca_dct8_intrin_avx2(const int16_t *src, int16_t *dst, intptr_t stride);
+void vca_dct16_intrin_avx2(const int16_t *src, int16_t *dst, intptr_t stride);
+void vca_dct32_intrin_avx2(const int16_t *src, int16_t *dst, intptr_t stride);
+
+// Same transforms but reading 8 bit samples directly from the frame
+void vca_dct8_u8_avx2(const uint8_t *src, int16_t *dst, intptr_t stride);
+void vca_dct16_u8_avx2(const uint8_t *src, int16_t *dst, intptr_t stride);
+void vca_dct32_u8_avx2(const uint8_t *src, int16_t *dst, intptr_t stride);
+
+// Same transforms but reading 10 or 12 bit samples directly from the frame
+void vca_dct8_u16_avx2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
+void vca_dct16_u16_avx2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
+void vca_dct32_u16_avx2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
+
+// Transform 4 horizontally adjacent 8x8 blocks directly from the frame and write the weighted
+// coefficient sum of each block (see energy.h) to energies[0..3]. The u16 version supports
+// 10 and 12 bit.
+void vca_dct8_energy4_u8_avx2(const uint8_t *src,
+                              intptr_t stride,
+                              const uint16_t *weights,
+                              uint32_t *energies);
+void vca_dct8_energy4_u16_avx2(const uint16_t *src,
+                               intptr_t stride,
+                               const uint16_t *weights,
+                               uint32_t *energies,
+                               unsigned bitDepth);
@@ -0,0 +1,403 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "dct-avx512.h"
+#include "dct-tables.h"
+
+#include <analyzer/common.h>
+
+#include <immintrin.h> // AVX-512 F/BW/VL
+
+// The transforms are computed as two matrix multiplications using pmaddwd on pairs of
+// coefficients. The 32 bit sums are identical to the partial butterflies of the C code.
+//  - The first stage splits each row into even and odd parts (E/O). Every output lane then
+//    selects either an E or an O pair. These 16 bit sums do not overflow for up to 12 bit input.
+//  - The second stage operates on the columns of the intermediate block. Here the E/O split
+//    could overflow 16 bit so it multiplies the full columns using interleaved pairs of rows.
+// Unlike the SSSE3 and x265 assembly kernels the intermediate block is not transposed.
+
+#define DCT_SHIFT1(N) (((N) == 8 ? 2 : (N) == 16 ? 3 : 4) + bitDepth - 8)
+#define DCT_SHIFT2(N) ((N) == 8 ? 9 : (N) == 16 ? 10 : 11)
+
+namespace {
+
+using namespace vca::dct_tables;
+
+// For 8x8 two output rows (k = 2m and 2m + 1) are computed per register so the coefficient
+// pairs differ between the lower and the upper 8 lanes.
+struct SecondStageTable8
+{
+    int32_t pair[4][4][16];
+};
+
+constexpr SecondStageTable8 makeSecondStageTable8()
+{
+    SecondStageTable8 table{};
+    for (int m = 0; m < 4; m++)
+        for (int q = 0; q < 4; q++)
+            for (int lane = 0; lane < 16; lane++)
+            {
+                const auto k           = 2 * m + lane / 8;
+                table.pair[m][q][lane] = makePair(transformCoeff(8, k, 2 * q),
+                                                  transformCoeff(8, k, 2 * q + 1));
+            }
+    return table;
+}
+
+// Word permutations for vpermw / vpermt2w
+struct WordIndex
+{
+    int16_t index[32];
+};
+
+constexpr WordIndex makeReverseIndex()
+{
+    WordIndex table{};
+    for (int i = 0; i < 32; i++)
+        table.index[i] = int16_t(31 - i);
+    return table;
+}
+
+// Lane 2i takes word (first + i % width) and lane 2i + 1 takes word (second + i % width)
+constexpr WordIndex makeInterleaveIndex(int first, int second, int width)
+{
+    WordIndex table{};
+    for (int i = 0; i < 16; i++)
+    {
+        table.index[2 * i]     = int16_t(first + i % width);
+        table.index[2 * i + 1] = int16_t(second + i % width);
+    }
+    return table;
+}
+
+ALIGN_VAR_64(constexpr auto, tab_dct8_1)  = makeFirstStageTable<8>();
+ALIGN_VAR_64(constexpr auto, tab_dct16_1) = makeFirstStageTable<16>();
+ALIGN_VAR_64(constexpr auto, tab_dct32_1) = makeFirstStageTable<32>();
+ALIGN_VAR_64(constexpr auto, tab_dct8_2)  = makeSecondStageTable8();
+ALIGN_VAR_64(constexpr auto, tab_dct16_2) = makeSecondStageTable<16>();
+ALIGN_VAR_64(constexpr auto, tab_dct32_2) = makeSecondStageTable<32>();
+
+ALIGN_VAR_64(constexpr WordIndex, idx_dct8_rows[4]) = {makeInterleaveIndex(0, 8, 8),
+                                                       makeInterleaveIndex(16, 24, 8),
+                                                       makeInterleaveIndex(32, 40, 8),
+                                                       makeInterleaveIndex(48, 56, 8)};
+ALIGN_VAR_64(constexpr auto, idx_dct16_rows)    = makeInterleaveIndex(0, 16, 16);
+ALIGN_VAR_64(constexpr auto, idx_dct32_reverse) = makeReverseIndex();
+ALIGN_VAR_64(constexpr WordIndex, idx_dct32_rows[2]) = {makeInterleaveIndex(0, 32, 16),
+                                                        makeInterleaveIndex(16, 48, 16)};
+
+// Even output lanes select the E pair p from the sum (index p) and odd lanes the O pair from
+// the difference (index 16 + p). For 8x8 the second row starts at dword 4.
+inline __m512i firstStageSelect(int p)
+{
+    const __m512i base = _mm512_set_epi32(16, 0, 16, 0, 16, 0, 16, 0, 16, 0, 16, 0, 16, 0, 16, 0);
+    return _mm512_add_epi32(base, _mm512_set1_epi32(p));
+}
+
+inline __m512i firstStageSelect8(int p)
+{
+    const __m512i base = _mm512_set_epi32(20, 4, 20, 4, 20, 4, 20, 4, 16, 0, 16, 0, 16, 0, 16, 0);
+    return _mm512_add_epi32(base, _mm512_set1_epi32(p));
+}
+
+// The unmasked forms of the shift and the narrowing below start from an undefined register which
+// GCC reports as used uninitialized. The masked forms with all lanes set are the same operation.
+template<int shift> inline __m512i roundAndShift(__m512i sum)
+{
+    const auto rounded = _mm512_add_epi32(sum, _mm512_set1_epi32(1 << (shift - 1)));
+    return _mm512_mask_srai_epi32(_mm512_setzero_si512(), __mmask16(0xFFFF), rounded, shift);
+}
+
+// Truncate the 16 dwords to 16 words
+inline __m256i narrowToWords(__m512i value)
+{
+    return _mm512_mask_cvtepi32_epi16(_mm256_setzero_si256(), __mmask16(0xFFFF), value);
+}
+
+// Load rows of the source block. 8 bit samples are widened to 16 bit while loading.
+inline __m512i loadRow32(const int16_t *src)
+{
+    return _mm512_loadu_si512(src);
+}
+
+inline __m512i loadRow32(const uint16_t *src)
+{
+    return _mm512_loadu_si512(src);
+}
+
+inline __m512i loadRow32(const uint8_t *src)
+{
+    return _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *) src));
+}
+
+inline __m256i loadRow16(const int16_t *src)
+{
+    return _mm256_loadu_si256((const __m256i *) src);
+}
+
+inline __m256i loadRow16(const uint16_t *src)
+{
+    return _mm256_loadu_si256((const __m256i *) src);
+}
+
+inline __m256i loadRow16(const uint8_t *src)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) src));
+}
+
+inline __m256i loadTwoRows8(const int16_t *src, intptr_t stride)
+{
+    __m128i rowA = _mm_loadu_si128((const __m128i *) src);
+    __m128i rowB = _mm_loadu_si128((const __m128i *) (src + stride));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(rowA), rowB, 1);
+}
+
+inline __m256i loadTwoRows8(const uint16_t *src, intptr_t stride)
+{
+    __m128i rowA = _mm_loadu_si128((const __m128i *) src);
+    __m128i rowB = _mm_loadu_si128((const __m128i *) (src + stride));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(rowA), rowB, 1);
+}
+
+inline __m256i loadTwoRows8(const uint8_t *src, intptr_t stride)
+{
+    __m128i rowA = _mm_loadl_epi64((const __m128i *) src);
+    __m128i rowB = _mm_loadl_epi64((const __m128i *) (src + stride));
+    return _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(rowA, rowB));
+}
+
+template<int bitDepth, typename PixelType>
+void dct8(const PixelType *src, int16_t *dst, intptr_t stride)
+{
+    const __m256i reverse = _mm256_set_epi16(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512i select0 = firstStageSelect8(0);
+    const __m512i select1 = firstStageSelect8(1);
+
+    ALIGN_VAR_64(int16_t, tmp[8 * 8]);
+
+    // First stage: two rows per iteration
+    for (int j = 0; j < 8; j += 2)
+    {
+        __m256i rows = loadTwoRows8(&src[j * stride], stride);
+        __m256i rev  = _mm256_permutexvar_epi16(reverse, rows);
+        __m512i E    = _mm512_castsi256_si512(_mm256_add_epi16(rows, rev));
+        __m512i O    = _mm512_castsi256_si512(_mm256_sub_epi16(rows, rev));
+
+        __m512i pairs0 = _mm512_permutex2var_epi32(E, select0, O);
+        __m512i pairs1 = _mm512_permutex2var_epi32(E, select1, O);
+        __m512i sum    = _mm512_add_epi32(
+            _mm512_madd_epi16(pairs0, _mm512_load_si512(tab_dct8_1.pair[0])),
+            _mm512_madd_epi16(pairs1, _mm512_load_si512(tab_dct8_1.pair[1])));
+
+        _mm256_store_si256((__m256i *) &tmp[j * 8],
+                           narrowToWords(roundAndShift<DCT_SHIFT1(8)>(sum)));
+    }
+
+    // Second stage: the pairs of rows (2q, 2q + 1) are interleaved and repeated in both halves
+    const __m512i rows0to3 = _mm512_load_si512(&tmp[0]);
+    const __m512i rows4to7 = _mm512_load_si512(&tmp[32]);
+    __m512i rowPairs[4];
+    for (int q = 0; q < 4; q++)
+        rowPairs[q] = _mm512_permutex2var_epi16(rows0to3,
+                                                _mm512_load_si512(idx_dct8_rows[q].index),
+                                                rows4to7);
+
+    for (int m = 0; m < 4; m++)
+    {
+        __m512i sum = _mm512_setzero_si512();
+        for (int q = 0; q < 4; q++)
+        {
+            __m512i coeff = _mm512_load_si512(tab_dct8_2.pair[m][q]);
+            sum           = _mm512_add_epi32(sum, _mm512_madd_epi16(rowPairs[q], coeff));
+        }
+
+        _mm256_storeu_si256((__m256i *) &dst[m * 16],
+                            narrowToWords(roundAndShift<DCT_SHIFT2(8)>(sum)));
+    }
+}
+
+template<int bitDepth, typename PixelType>
+void dct16(const PixelType *src, int16_t *dst, intptr_t stride)
+{
+    const __m256i reverse = _mm256_set_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    ALIGN_VAR_64(int16_t, tmp[16 * 16]);
+
+    // First stage
+    for (int j = 0; j < 16; j++)
+    {
+        __m256i row = loadRow16(&src[j * stride]);
+        __m256i rev = _mm256_permutexvar_epi16(reverse, row);
+        __m512i E   = _mm512_castsi256_si512(_mm256_add_epi16(row, rev));
+        __m512i O   = _mm512_castsi256_si512(_mm256_sub_epi16(row, rev));
+
+        __m512i sum = _mm512_setzero_si512();
+        for (int p = 0; p < 4; p++)
+        {
+            __m512i pairs = _mm512_permutex2var_epi32(E, firstStageSelect(p), O);
+            __m512i coeff = _mm512_load_si512(tab_dct16_1.pair[p]);
+            sum           = _mm512_add_epi32(sum, _mm512_madd_epi16(pairs, coeff));
+        }
+
+        _mm256_store_si256((__m256i *) &tmp[j * 16],
+                           narrowToWords(roundAndShift<DCT_SHIFT1(16)>(sum)));
+    }
+
+    // Second stage: interleave the rows (2q, 2q + 1) which are adjacent in memory
+    const __m512i interleaveIndex = _mm512_load_si512(idx_dct16_rows.index);
+
+    __m512i rowPairs[8];
+    for (int q = 0; q < 8; q++)
+        rowPairs[q] = _mm512_permutexvar_epi16(interleaveIndex,
+                                               _mm512_load_si512(&tmp[2 * q * 16]));
+
+    for (int k = 0; k < 16; k++)
+    {
+        __m512i sum = _mm512_setzero_si512();
+        for (int q = 0; q < 8; q++)
+        {
+            __m512i coeff = _mm512_set1_epi32(tab_dct16_2.pair[k][q]);
+            sum           = _mm512_add_epi32(sum, _mm512_madd_epi16(rowPairs[q], coeff));
+        }
+
+        _mm256_storeu_si256((__m256i *) &dst[k * 16],
+                            narrowToWords(roundAndShift<DCT_SHIFT2(16)>(sum)));
+    }
+}
+
+template<int bitDepth, typename PixelType>
+void dct32(const PixelType *src, int16_t *dst, intptr_t stride)
+{
+    const __m512i reverse = _mm512_load_si512(idx_dct32_reverse.index);
+
+    ALIGN_VAR_64(int16_t, tmp[32 * 32]);
+
+    // First stage
+    for (int j = 0; j < 32; j++)
+    {
+        __m512i row = loadRow32(&src[j * stride]);
+        __m512i rev = _mm512_permutexvar_epi16(reverse, row);
+        __m512i E   = _mm512_add_epi16(row, rev);
+        __m512i O   = _mm512_sub_epi16(row, rev);
+
+        __m512i sumLow  = _mm512_setzero_si512();
+        __m512i sumHigh = _mm512_setzero_si512();
+        for (int p = 0; p < 8; p++)
+        {
+            __m512i pairs     = _mm512_permutex2var_epi32(E, firstStageSelect(p), O);
+            __m512i coeffLow  = _mm512_load_si512(&tab_dct32_1.pair[p][0]);
+            __m512i coeffHigh = _mm512_load_si512(&tab_dct32_1.pair[p][16]);
+            sumLow            = _mm512_add_epi32(sumLow, _mm512_madd_epi16(pairs, coeffLow));
+            sumHigh           = _mm512_add_epi32(sumHigh, _mm512_madd_epi16(pairs, coeffHigh));
+        }
+
+        _mm256_store_si256((__m256i *) &tmp[j * 32],
+                           narrowToWords(roundAndShift<DCT_SHIFT1(32)>(sumLow)));
+        _mm256_store_si256((__m256i *) &tmp[j * 32 + 16],
+                           narrowToWords(roundAndShift<DCT_SHIFT1(32)>(sumHigh)));
+    }
+
+    // Second stage: interleave the rows (2q, 2q + 1)
+    const __m512i indexLow  = _mm512_load_si512(idx_dct32_rows[0].index);
+    const __m512i indexHigh = _mm512_load_si512(idx_dct32_rows[1].index);
+
+    ALIGN_VAR_64(int16_t, rowPairs[16][2][32]);
+    for (int q = 0; q < 16; q++)
+    {
+        __m512i rowA = _mm512_load_si512(&tmp[2 * q * 32]);
+        __m512i rowB = _mm512_load_si512(&tmp[(2 * q + 1) * 32]);
+        _mm512_store_si512(rowPairs[q][0], _mm512_permutex2var_epi16(rowA, indexLow, rowB));
+        _mm512_store_si512(rowPairs[q][1], _mm512_permutex2var_epi16(rowA, indexHigh, rowB));
+    }
+
+    for (int k = 0; k < 32; k++)
+    {
+        __m512i sumLow  = _mm512_setzero_si512();
+        __m512i sumHigh = _mm512_setzero_si512();
+        for (int q = 0; q < 16; q++)
+        {
+            __m512i coeff = _mm512_set1_epi32(tab_dct32_2.pair[k][q]);
+            __m512i low   = _mm512_load_si512(rowPairs[q][0]);
+            __m512i high  = _mm512_load_si512(rowPairs[q][1]);
+            sumLow        = _mm512_add_epi32(sumLow, _mm512_madd_epi16(low, coeff));
+            sumHigh       = _mm512_add_epi32(sumHigh, _mm512_madd_epi16(high, coeff));
+        }
+
+        _mm256_storeu_si256((__m256i *) &dst[k * 32],
+                            narrowToWords(roundAndShift<DCT_SHIFT2(32)>(sumLow)));
+        _mm256_storeu_si256((__m256i *) &dst[k * 32 + 16],
+                            narrowToWords(roundAndShift<DCT_SHIFT2(32)>(sumHigh)));
+    }
+}
+
+} // namespace
+
+void vca_dct8_avx512(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dct8<8>(src, dst, stride);
+}
+
+void vca_dct8_u8_avx512(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dct8<8>(src, dst, stride);
+}
+
+void vca_dct8_u16_avx512(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct8<10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dct8<12>(src, dst, stride);
+}
+
+void vca_dct16_avx512(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dct16<8>(src, dst, stride);
+}
+
+void vca_dct16_u8_avx512(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dct16<8>(src, dst, stride);
+}
+
+void vca_dct16_u16_avx512(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct16<10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dct16<12>(src, dst, stride);
+}
+
+void vca_dct32_avx512(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dct32<8>(src, dst, stride);
+}
+
+void vca_dct32_u8_avx512(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dct32<8>(src, dst, stride);
+}
+
+void vca_dct32_u16_avx512(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct32<10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dct32<12>(src, dst, stride);
+}
@@ -0,0 +1,36 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+void vca_dct8_avx512(const int16_t *src, int16_t *dst, intptr_t stride);
+void vca_dct16_avx512(const int16_t *src, int16_t *dst, intptr_t stride);
+void vca_dct32_avx512(const int16_t *src, int16_t *dst, intptr_t stride);
+
+// Same transforms but reading 8 bit samples directly from the frame
+void vca_dct8_u8_avx512(const uint8_t *src, int16_t *dst, intptr_t stride);
+void vca_dct16_u8_avx512(const uint8_t *src, int16_t *dst, intptr_t stride);
+void vca_dct32_u8_avx512(const uint8_t *src, int16_t *dst, intptr_t stride);
+
+// Same transforms but reading 10 or 12 bit samples directly from the frame
+void vca_dct8_u16_avx512(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
+void vca_dct16_u16_avx512(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
+void vca_dct32_u16_avx512(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
@@ -0,0 +1,149 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "dct-sse2.h"
+#include "dct-tables.h"
+
+#include <analyzer/common.h>
+
+#include <emmintrin.h> // SSE2
+
+// The 8x8 transform as two matrix multiplications using pmaddwd like the AVX2 kernels.
+//  - The first stage splits each row into even and odd parts (E/O). The pair p of E and of O
+//    is broadcast so that the even output lanes use the E pair and the odd lanes the O pair.
+//  - The second stage operates on the columns of the intermediate block using interleaved pairs
+//    of rows.
+
+#define DCT8_SHIFT1 (2 + bitDepth - 8)
+#define DCT8_SHIFT2 9
+
+namespace {
+
+using namespace vca::dct_tables;
+
+ALIGN_VAR_32(constexpr auto, tab_dct8_1) = makeFirstStageTable<8>();
+ALIGN_VAR_32(constexpr auto, tab_dct8_2) = makeSecondStageTable<8>();
+
+template<int shift> inline __m128i roundAndShift(__m128i sum)
+{
+    return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1 << (shift - 1))), shift);
+}
+
+// Load the 8 samples of a row. 8 bit samples are widened to 16 bit while loading.
+inline __m128i loadPixels(const int16_t *src)
+{
+    return _mm_loadu_si128((const __m128i *) src);
+}
+
+inline __m128i loadPixels(const uint16_t *src)
+{
+    return _mm_loadu_si128((const __m128i *) src);
+}
+
+inline __m128i loadPixels(const uint8_t *src)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) src), _mm_setzero_si128());
+}
+
+// SSE2 has no pshufb so the words are reversed within the qwords and then the qwords swapped
+inline __m128i reverseWords(__m128i value)
+{
+    value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3)),
+                                _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+inline __m128i loadCoeff(const int32_t *pair)
+{
+    return _mm_load_si128((const __m128i *) pair);
+}
+
+template<int bitDepth, typename PixelType>
+void dct8(const PixelType *src, int16_t *dst, intptr_t stride)
+{
+    __m128i tmp[8];
+
+    // First stage
+    for (int j = 0; j < 8; j++)
+    {
+        const auto row = loadPixels(&src[j * stride]);
+        const auto rev = reverseWords(row);
+        const auto E   = _mm_add_epi16(row, rev);
+        const auto O   = _mm_sub_epi16(row, rev);
+
+        const auto eo    = _mm_unpacklo_epi32(E, O);
+        const auto pair0 = _mm_shuffle_epi32(eo, _MM_SHUFFLE(1, 0, 1, 0));
+        const auto pair1 = _mm_shuffle_epi32(eo, _MM_SHUFFLE(3, 2, 3, 2));
+
+        // The outputs k = 0 to 3 and 4 to 7
+        const auto &coeff  = tab_dct8_1.pair;
+        const auto sumLow  = _mm_add_epi32(_mm_madd_epi16(pair0, loadCoeff(&coeff[0][0])),
+                                           _mm_madd_epi16(pair1, loadCoeff(&coeff[1][0])));
+        const auto sumHigh = _mm_add_epi32(_mm_madd_epi16(pair0, loadCoeff(&coeff[0][4])),
+                                           _mm_madd_epi16(pair1, loadCoeff(&coeff[1][4])));
+
+        tmp[j] = _mm_packs_epi32(roundAndShift<DCT8_SHIFT1>(sumLow),
+                                 roundAndShift<DCT8_SHIFT1>(sumHigh));
+    }
+
+    // Second stage: interleave the rows (2q, 2q + 1) for the columns 0 to 3 and 4 to 7
+    __m128i rowPairsLow[4];
+    __m128i rowPairsHigh[4];
+    for (int q = 0; q < 4; q++)
+    {
+        rowPairsLow[q]  = _mm_unpacklo_epi16(tmp[2 * q], tmp[2 * q + 1]);
+        rowPairsHigh[q] = _mm_unpackhi_epi16(tmp[2 * q], tmp[2 * q + 1]);
+    }
+
+    for (int k = 0; k < 8; k++)
+    {
+        __m128i sumLow  = _mm_setzero_si128();
+        __m128i sumHigh = _mm_setzero_si128();
+        for (int q = 0; q < 4; q++)
+        {
+            const auto coeff = _mm_set1_epi32(tab_dct8_2.pair[k][q]);
+            sumLow           = _mm_add_epi32(sumLow, _mm_madd_epi16(rowPairsLow[q], coeff));
+            sumHigh          = _mm_add_epi32(sumHigh, _mm_madd_epi16(rowPairsHigh[q], coeff));
+        }
+
+        _mm_storeu_si128((__m128i *) &dst[k * 8],
+                         _mm_packs_epi32(roundAndShift<DCT8_SHIFT2>(sumLow),
+                                         roundAndShift<DCT8_SHIFT2>(sumHigh)));
+    }
+}
+
+} // namespace
+
+void vca_dct8_intrin_sse2(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dct8<8>(src, dst, stride);
+}
+
+void vca_dct8_u8_sse2(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dct8<8>(src, dst, stride);
+}
+
+void vca_dct8_u16_sse2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct8<10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dct8<12>(src, dst, stride);
+}
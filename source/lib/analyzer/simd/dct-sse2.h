@@ -0,0 +1,32 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+// Intrinsics versions of the 8x8 transform. The assembly kernel of the same instruction set uses
+// the plain name (see dct8.h) so this one is called intrin. It is used in builds without NASM.
+void vca_dct8_intrin_sse2(const int16_t *src, int16_t *dst, intptr_t stride);
+
+// Same transform but reading 8 bit samples directly from the frame
+void vca_dct8_u8_sse2(const uint8_t *src, int16_t *dst, intptr_t stride);
+
+// Same transform but reading 10 or 12 bit samples directly from the frame
+void vca_dct8_u16_sse2(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
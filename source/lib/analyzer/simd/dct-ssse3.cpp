@@ -30,10 +30,9 @@
 #include <tmmintrin.h> // SSSE3
 #include <xmmintrin.h> // SSE
 
-// This means that >8 bit stuff will not work now. TODO: Fix
-#define VCA_DEPTH 8
-
-#define DCT16_SHIFT1 (3 + VCA_DEPTH - 8)
+// The first stage shift depends on the bit depth which is a template parameter of the transforms.
+// The 16 bit intermediate sums of the first stage do not overflow for up to 12 bit input.
+#define DCT16_SHIFT1 (3 + bitDepth - 8)
 #define DCT16_ADD1 (1 << ((DCT16_SHIFT1) -1))
 
 #define DCT16_SHIFT2 10
@@ -47,6 +46,26 @@
 
 using namespace vca;
 
+namespace {
+
+// Load 8 values of a row of the source block. 8 bit samples are widened to 16 bit here so that the
+// first stage of the transform can directly read from the frame.
+inline __m128i loadPixels(const int16_t *src)
+{
+    return _mm_load_si128((const __m128i *) src);
+}
+
+inline __m128i loadPixels(const uint8_t *src)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) src), _mm_setzero_si128());
+}
+
+// High bit depth samples are read from the frame which gives no alignment guarantees
+inline __m128i loadPixels(const uint16_t *src)
+{
+    return _mm_loadu_si128((const __m128i *) src);
+}
+
 ALIGN_VAR_32(static const int16_t, tab_dct_8[][8]) = {
     {0x0100, 0x0F0E, 0x0706, 0x0908, 0x0302, 0x0D0C, 0x0504, 0x0B0A},
 
@@ -103,7 +122,8 @@ ALIGN_VAR_32(static const int16_t, tab_dct_16_1[][8])
 #undef MAKE_COEF
 };
 
-void vca_dct16_ssse3(const int16_t *src, int16_t *dst, intptr_t stride)
+template<int bitDepth, typename PixelType>
+void dct16(const PixelType *src, int16_t *dst, intptr_t stride)
 {
     // Const
     __m128i c_4   = _mm_set1_epi32(DCT16_ADD1);
@@ -126,22 +146,22 @@ void vca_dct16_ssse3(const int16_t *src, int16_t *dst, intptr_t stride)
     // DCT1
     for (i = 0; i < 16; i += 8)
     {
-        T00A = _mm_load_si128((__m128i *) &src[(i + 0) * stride + 0]); // [07 06 05 04 03 02 01 00]
-        T00B = _mm_load_si128((__m128i *) &src[(i + 0) * stride + 8]); // [0F 0E 0D 0C 0B 0A 09 08]
-        T01A = _mm_load_si128((__m128i *) &src[(i + 1) * stride + 0]); // [17 16 15 14 13 12 11 10]
-        T01B = _mm_load_si128((__m128i *) &src[(i + 1) * stride + 8]); // [1F 1E 1D 1C 1B 1A 19 18]
-        T02A = _mm_load_si128((__m128i *) &src[(i + 2) * stride + 0]); // [27 26 25 24 23 22 21 20]
-        T02B = _mm_load_si128((__m128i *) &src[(i + 2) * stride + 8]); // [2F 2E 2D 2C 2B 2A 29 28]
-        T03A = _mm_load_si128((__m128i *) &src[(i + 3) * stride + 0]); // [37 36 35 34 33 32 31 30]
-        T03B = _mm_load_si128((__m128i *) &src[(i + 3) * stride + 8]); // [3F 3E 3D 3C 3B 3A 39 38]
-        T04A = _mm_load_si128((__m128i *) &src[(i + 4) * stride + 0]); // [47 46 45 44 43 42 41 40]
-        T04B = _mm_load_si128((__m128i *) &src[(i + 4) * stride + 8]); // [4F 4E 4D 4C 4B 4A 49 48]
-        T05A = _mm_load_si128((__m128i *) &src[(i + 5) * stride + 0]); // [57 56 55 54 53 52 51 50]
-        T05B = _mm_load_si128((__m128i *) &src[(i + 5) * stride + 8]); // [5F 5E 5D 5C 5B 5A 59 58]
-        T06A = _mm_load_si128((__m128i *) &src[(i + 6) * stride + 0]); // [67 66 65 64 63 62 61 60]
-        T06B = _mm_load_si128((__m128i *) &src[(i + 6) * stride + 8]); // [6F 6E 6D 6C 6B 6A 69 68]
-        T07A = _mm_load_si128((__m128i *) &src[(i + 7) * stride + 0]); // [77 76 75 74 73 72 71 70]
-        T07B = _mm_load_si128((__m128i *) &src[(i + 7) * stride + 8]); // [7F 7E 7D 7C 7B 7A 79 78]
+        T00A = loadPixels(&src[(i + 0) * stride + 0]); // [07 06 05 04 03 02 01 00]
+        T00B = loadPixels(&src[(i + 0) * stride + 8]); // [0F 0E 0D 0C 0B 0A 09 08]
+        T01A = loadPixels(&src[(i + 1) * stride + 0]); // [17 16 15 14 13 12 11 10]
+        T01B = loadPixels(&src[(i + 1) * stride + 8]); // [1F 1E 1D 1C 1B 1A 19 18]
+        T02A = loadPixels(&src[(i + 2) * stride + 0]); // [27 26 25 24 23 22 21 20]
+        T02B = loadPixels(&src[(i + 2) * stride + 8]); // [2F 2E 2D 2C 2B 2A 29 28]
+        T03A = loadPixels(&src[(i + 3) * stride + 0]); // [37 36 35 34 33 32 31 30]
+        T03B = loadPixels(&src[(i + 3) * stride + 8]); // [3F 3E 3D 3C 3B 3A 39 38]
+        T04A = loadPixels(&src[(i + 4) * stride + 0]); // [47 46 45 44 43 42 41 40]
+        T04B = loadPixels(&src[(i + 4) * stride + 8]); // [4F 4E 4D 4C 4B 4A 49 48]
+        T05A = loadPixels(&src[(i + 5) * stride + 0]); // [57 56 55 54 53 52 51 50]
+        T05B = loadPixels(&src[(i + 5) * stride + 8]); // [5F 5E 5D 5C 5B 5A 59 58]
+        T06A = loadPixels(&src[(i + 6) * stride + 0]); // [67 66 65 64 63 62 61 60]
+        T06B = loadPixels(&src[(i + 6) * stride + 8]); // [6F 6E 6D 6C 6B 6A 69 68]
+        T07A = loadPixels(&src[(i + 7) * stride + 0]); // [77 76 75 74 73 72 71 70]
+        T07B = loadPixels(&src[(i + 7) * stride + 8]); // [7F 7E 7D 7C 7B 7A 79 78]
 
         T00B = _mm_shuffle_epi8(T00B, _mm_load_si128((__m128i *) tab_dct_16_0[0]));
         T01B = _mm_shuffle_epi8(T01B, _mm_load_si128((__m128i *) tab_dct_16_0[0]));
@@ -665,7 +685,8 @@ ALIGN_VAR_32(static const int16_t, tab_dct_32_1[][8]) = {
 #undef MAKE_COEF16
 };
 
-void vca_dct32_ssse3(const int16_t *src, int16_t *dst, intptr_t stride)
+template<int bitDepth, typename PixelType>
+void dct32(const PixelType *src, int16_t *dst, intptr_t stride)
 {
     // Const
     __m128i c_8    = _mm_set1_epi32(DCT32_ADD1);
@@ -689,42 +710,38 @@ void vca_dct32_ssse3(const int16_t *src, int16_t *dst, intptr_t stride)
     // DCT1
     for (i = 0; i < 32 / 8; i++)
     {
-        T00A = _mm_load_si128(
-            (__m128i *) &src[(i * 8 + 0) * stride + 0]); // [07 06 05 04 03 02 01 00]
-        T00B = _mm_load_si128(
-            (__m128i *) &src[(i * 8 + 0) * stride + 8]); // [15 14 13 12 11 10 09 08]
-        T00C = _mm_load_si128(
-            (__m128i *) &src[(i * 8 + 0) * stride + 16]); // [23 22 21 20 19 18 17 16]
-        T00D = _mm_load_si128(
-            (__m128i *) &src[(i * 8 + 0) * stride + 24]); // [31 30 29 28 27 26 25 24]
-        T01A = _mm_load_si128((__m128i *) &src[(i * 8 + 1) * stride + 0]);
-        T01B = _mm_load_si128((__m128i *) &src[(i * 8 + 1) * stride + 8]);
-        T01C = _mm_load_si128((__m128i *) &src[(i * 8 + 1) * stride + 16]);
-        T01D = _mm_load_si128((__m128i *) &src[(i * 8 + 1) * stride + 24]);
-        T02A = _mm_load_si128((__m128i *) &src[(i * 8 + 2) * stride + 0]);
-        T02B = _mm_load_si128((__m128i *) &src[(i * 8 + 2) * stride + 8]);
-        T02C = _mm_load_si128((__m128i *) &src[(i * 8 + 2) * stride + 16]);
-        T02D = _mm_load_si128((__m128i *) &src[(i * 8 + 2) * stride + 24]);
-        T03A = _mm_load_si128((__m128i *) &src[(i * 8 + 3) * stride + 0]);
-        T03B = _mm_load_si128((__m128i *) &src[(i * 8 + 3) * stride + 8]);
-        T03C = _mm_load_si128((__m128i *) &src[(i * 8 + 3) * stride + 16]);
-        T03D = _mm_load_si128((__m128i *) &src[(i * 8 + 3) * stride + 24]);
-        T04A = _mm_load_si128((__m128i *) &src[(i * 8 + 4) * stride + 0]);
-        T04B = _mm_load_si128((__m128i *) &src[(i * 8 + 4) * stride + 8]);
-        T04C = _mm_load_si128((__m128i *) &src[(i * 8 + 4) * stride + 16]);
-        T04D = _mm_load_si128((__m128i *) &src[(i * 8 + 4) * stride + 24]);
-        T05A = _mm_load_si128((__m128i *) &src[(i * 8 + 5) * stride + 0]);
-        T05B = _mm_load_si128((__m128i *) &src[(i * 8 + 5) * stride + 8]);
-        T05C = _mm_load_si128((__m128i *) &src[(i * 8 + 5) * stride + 16]);
-        T05D = _mm_load_si128((__m128i *) &src[(i * 8 + 5) * stride + 24]);
-        T06A = _mm_load_si128((__m128i *) &src[(i * 8 + 6) * stride + 0]);
-        T06B = _mm_load_si128((__m128i *) &src[(i * 8 + 6) * stride + 8]);
-        T06C = _mm_load_si128((__m128i *) &src[(i * 8 + 6) * stride + 16]);
-        T06D = _mm_load_si128((__m128i *) &src[(i * 8 + 6) * stride + 24]);
-        T07A = _mm_load_si128((__m128i *) &src[(i * 8 + 7) * stride + 0]);
-        T07B = _mm_load_si128((__m128i *) &src[(i * 8 + 7) * stride + 8]);
-        T07C = _mm_load_si128((__m128i *) &src[(i * 8 + 7) * stride + 16]);
-        T07D = _mm_load_si128((__m128i *) &src[(i * 8 + 7) * stride + 24]);
+        T00A = loadPixels(&src[(i * 8 + 0) * stride + 0]);  // [07 06 05 04 03 02 01 00]
+        T00B = loadPixels(&src[(i * 8 + 0) * stride + 8]);  // [15 14 13 12 11 10 09 08]
+        T00C = loadPixels(&src[(i * 8 + 0) * stride + 16]); // [23 22 21 20 19 18 17 16]
+        T00D = loadPixels(&src[(i * 8 + 0) * stride + 24]); // [31 30 29 28 27 26 25 24]
+        T01A = loadPixels(&src[(i * 8 + 1) * stride + 0]);
+        T01B = loadPixels(&src[(i * 8 + 1) * stride + 8]);
+        T01C = loadPixels(&src[(i * 8 + 1) * stride + 16]);
+        T01D = loadPixels(&src[(i * 8 + 1) * stride + 24]);
+        T02A = loadPixels(&src[(i * 8 + 2) * stride + 0]);
+        T02B = loadPixels(&src[(i * 8 + 2) * stride + 8]);
+        T02C = loadPixels(&src[(i * 8 + 2) * stride + 16]);
+        T02D = loadPixels(&src[(i * 8 + 2) * stride + 24]);
+        T03A = loadPixels(&src[(i * 8 + 3) * stride + 0]);
+        T03B = loadPixels(&src[(i * 8 + 3) * stride + 8]);
+        T03C = loadPixels(&src[(i * 8 + 3) * stride + 16]);
+        T03D = loadPixels(&src[(i * 8 + 3) * stride + 24]);
+        T04A = loadPixels(&src[(i * 8 + 4) * stride + 0]);
+        T04B = loadPixels(&src[(i * 8 + 4) * stride + 8]);
+        T04C = loadPixels(&src[(i * 8 + 4) * stride + 16]);
+        T04D = loadPixels(&src[(i * 8 + 4) * stride + 24]);
+        T05A = loadPixels(&src[(i * 8 + 5) * stride + 0]);
+        T05B = loadPixels(&src[(i * 8 + 5) * stride + 8]);
+        T05C = loadPixels(&src[(i * 8 + 5) * stride + 16]);
+        T05D = loadPixels(&src[(i * 8 + 5) * stride + 24]);
+        T06A = loadPixels(&src[(i * 8 + 6) * stride + 0]);
+        T06B = loadPixels(&src[(i * 8 + 6) * stride + 8]);
+        T06C = loadPixels(&src[(i * 8 + 6) * stride + 16]);
+        T06D = loadPixels(&src[(i * 8 + 6) * stride + 24]);
+        T07A = loadPixels(&src[(i * 8 + 7) * stride + 0]);
+        T07B = loadPixels(&src[(i * 8 + 7) * stride + 8]);
+        T07C = loadPixels(&src[(i * 8 + 7) * stride + 16]);
+        T07D = loadPixels(&src[(i * 8 + 7) * stride + 24]);
 
         T00A = _mm_shuffle_epi8(T00A,
                                 _mm_load_si128(
@@ -1117,6 +1134,44 @@ void vca_dct32_ssse3(const int16_t *src, int16_t *dst, intptr_t stride)
     }
 }
 
+} // namespace
+
+void vca_dct16_ssse3(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dct16<8>(src, dst, stride);
+}
+
+void vca_dct16_u8_ssse3(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dct16<8>(src, dst, stride);
+}
+
+void vca_dct16_u16_ssse3(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct16<10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dct16<12>(src, dst, stride);
+}
+
+void vca_dct32_ssse3(const int16_t *src, int16_t *dst, intptr_t stride)
+{
+    dct32<8>(src, dst, stride);
+}
+
+void vca_dct32_u8_ssse3(const uint8_t *src, int16_t *dst, intptr_t stride)
+{
+    dct32<8>(src, dst, stride);
+}
+
+void vca_dct32_u16_ssse3(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth)
+{
+    if (bitDepth == 10)
+        dct32<10>(src, dst, stride);
+    else if (bitDepth == 12)
+        dct32<12>(src, dst, stride);
+}
+
 // namespace VCA_NS {
 // void setupIntrinsicDCT_ssse3(AnalyzerPrimitives &p)
 // {
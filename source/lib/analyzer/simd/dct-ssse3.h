@@ -23,3 +23,11 @@
 
 void vca_dct16_ssse3(const int16_t* src, int16_t* dst, intptr_t srcStride);
 void vca_dct32_ssse3(const int16_t *src, int16_t *dst, intptr_t stride);
+
+// Same transforms but reading 8 bit samples directly from the frame
+void vca_dct16_u8_ssse3(const uint8_t *src, int16_t *dst, intptr_t stride);
+void vca_dct32_u8_ssse3(const uint8_t *src, int16_t *dst, intptr_t stride);
+
+// Same transforms but reading 10 or 12 bit samples directly from the frame
+void vca_dct16_u16_ssse3(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
+void vca_dct32_u16_ssse3(const uint16_t *src, int16_t *dst, intptr_t stride, unsigned bitDepth);
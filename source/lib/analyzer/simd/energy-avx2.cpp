@@ -0,0 +1,45 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "energy.h"
+
+#include <immintrin.h> // AVX2
+
+uint32_t vca_weighted_coeff_sum_avx2(const int16_t *coeff, const uint16_t *weights, intptr_t count)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum        = _mm256_setzero_si256();
+
+    for (intptr_t i = 0; i < count; i += 16)
+    {
+        // abs(-32768) is 0x8000 which is correct if interpreted as unsigned
+        __m256i c = _mm256_abs_epi16(_mm256_loadu_si256((const __m256i *) &coeff[i]));
+        __m256i w = _mm256_loadu_si256((const __m256i *) &weights[i]);
+
+        // The weights are scaled by 256 so the high half of the product is the weighted value
+        __m256i weighted = _mm256_mulhi_epu16(c, w);
+
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(weighted, ones));
+    }
+
+    __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    sum128         = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum128         = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+    return uint32_t(_mm_cvtsi128_si32(sum128));
+}
@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "energy.h"
+
+#include <immintrin.h> // AVX-512 F/BW
+
+uint32_t vca_weighted_coeff_sum_avx512(const int16_t *coeff,
+                                       const uint16_t *weights,
+                                       intptr_t count)
+{
+    const __m512i ones = _mm512_set1_epi16(1);
+    __m512i sum        = _mm512_setzero_si512();
+
+    // A 8x8 block only fills two registers so the last iteration may load a half register
+    for (intptr_t i = 0; i < count; i += 32)
+    {
+        const __mmask32 mask = count - i >= 32 ? __mmask32(0xFFFFFFFF) : __mmask32(0xFFFF);
+
+        // abs(-32768) is 0x8000 which is correct if interpreted as unsigned
+        __m512i c = _mm512_abs_epi16(_mm512_maskz_loadu_epi16(mask, &coeff[i]));
+        __m512i w = _mm512_maskz_loadu_epi16(mask, &weights[i]);
+
+        // The weights are scaled by 256 so the high half of the product is the weighted value
+        __m512i weighted = _mm512_mulhi_epu16(c, w);
+
+        sum = _mm512_add_epi32(sum, _mm512_madd_epi16(weighted, ones));
+    }
+
+    // _mm512_reduce_add_epi32 and the cast to 256 bit start from an undefined register which GCC
+    // reports as used uninitialized, so the halves are extracted with an explicit zero source.
+    const auto zero   = _mm256_setzero_si256();
+    const auto low    = _mm512_mask_extracti64x4_epi64(zero, 0xF, sum, 0);
+    const auto high   = _mm512_mask_extracti64x4_epi64(zero, 0xF, sum, 1);
+    const auto sum256 = _mm256_add_epi32(low, high);
+    __m128i sum128    = _mm_add_epi32(_mm256_castsi256_si128(sum256),
+                                      _mm256_extracti128_si256(sum256, 1));
+    sum128            = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum128            = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+    return uint32_t(_mm_cvtsi128_si32(sum128));
+}
@@ -0,0 +1,45 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#include "energy.h"
+
+#include <emmintrin.h> // SSE2
+#include <tmmintrin.h> // SSSE3
+
+uint32_t vca_weighted_coeff_sum_ssse3(const int16_t *coeff, const uint16_t *weights, intptr_t count)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum        = _mm_setzero_si128();
+
+    for (intptr_t i = 0; i < count; i += 8)
+    {
+        // abs(-32768) is 0x8000 which is correct if interpreted as unsigned
+        __m128i c = _mm_abs_epi16(_mm_loadu_si128((const __m128i *) &coeff[i]));
+        __m128i w = _mm_loadu_si128((const __m128i *) &weights[i]);
+
+        // The weights are scaled by 256 so the high half of the product is the weighted value
+        __m128i weighted = _mm_mulhi_epu16(c, w);
+
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(weighted, ones));
+    }
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return uint32_t(_mm_cvtsi128_si32(sum));
+}
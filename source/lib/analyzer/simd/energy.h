@@ -0,0 +1,33 @@
+/*****************************************************************************
+ * Copyright (C) 2022 Christian Doppler Laboratory ATHENA
+ *
+ * Authors: Christian Feldmann <christian.feldmann@bitmovin.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.
+ *****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+// Sum of (weights[i] * abs(coeff[i])) >> 16 over count coefficients. The weights are factors
+// in the range [0, 255] multiplied by 256, so each term is the 16 bit multiply-high of the
+// weight and the absolute coefficient. count must be a multiple of 16.
+uint32_t vca_weighted_coeff_sum_ssse3(const int16_t *coeff,
+                                      const uint16_t *weights,
+                                      intptr_t count);
+uint32_t vca_weighted_coeff_sum_avx2(const int16_t *coeff, const uint16_t *weights, intptr_t count);
+uint32_t vca_weighted_coeff_sum_avx512(const int16_t *coeff,
+                                       const uint16_t *weights,
+                                       intptr_t count);
@@ -22,7 +22,8 @@
 #include <assert.h>
 
 /// In case we have no NASM available or disabled, we use these dummy functions to link (which
-/// should never be called)
+/// should never be called). The intrinsics kernels in dct-sse2.cpp and dct-avx2.cpp are used
+/// instead.
 
 extern "C" {
 
@@ -60,12 +60,52 @@ DLL_PUBLIC vca_result vca_analyzer_pull_frame_result(vca_analyzer *enc, vca_fram
     return analyzer->pullResult(result);
 }
 
+DLL_PUBLIC vca_result vca_analyzer_borrow_frame_result(vca_analyzer *enc,
+                                                       const vca_borrowed_frame_results **result)
+{
+    if (enc == nullptr || result == nullptr)
+        return vca_result::VCA_ERROR;
+
+    auto analyzer = (vca::Analyzer *) (enc);
+    return analyzer->borrowResult(result);
+}
+
+DLL_PUBLIC void vca_analyzer_release_frame_result(vca_analyzer *enc,
+                                                  const vca_borrowed_frame_results *result)
+{
+    if (enc == nullptr || result == nullptr)
+        return;
+
+    auto analyzer = (vca::Analyzer *) (enc);
+    analyzer->releaseResult(result);
+}
+
 DLL_PUBLIC void vca_analyzer_close(vca_analyzer *enc)
 {
     auto analyzer = (vca::Analyzer *) enc;
     delete analyzer;
 }
 
+DLL_PUBLIC vca_result vca_analyzer_get_stats(vca_analyzer *enc, vca_analyzer_stats *stats)
+{
+    if (enc == nullptr || stats == nullptr)
+        return vca_result::VCA_ERROR;
+
+    auto analyzer = (vca::Analyzer *) (enc);
+    return analyzer->getStats(stats);
+}
+
+DLL_PUBLIC vca_result vca_analyzer_get_thread_stats(vca_analyzer *enc,
+                                                    unsigned threadIndex,
+                                                    vca_thread_stats *stats)
+{
+    if (enc == nullptr || stats == nullptr)
+        return vca_result::VCA_ERROR;
+
+    auto analyzer = (vca::Analyzer *) (enc);
+    return analyzer->getThreadStats(threadIndex, stats);
+}
+
 DLL_PUBLIC vca_result vca_shot_detection(const vca_shot_detection_param &param,
                                          vca_shot_detect_frame *frames,
                                          size_t num_frames)
@@ -79,4 +119,48 @@ DLL_PUBLIC vca_result vca_shot_detection(const vca_shot_detection_param &param,
     return vca::shot_detection(param, frames, num_frames);
 }
 
+DLL_PUBLIC vca_shot_detector *vca_shot_detector_open(vca_shot_detection_param param)
+{
+    return new vca::ShotDetector(param);
+}
+
+DLL_PUBLIC vca_result vca_shot_detector_push(vca_shot_detector *detector, double epsilon)
+{
+    if (detector == nullptr)
+        return vca_result::VCA_ERROR;
+
+    auto shotDetector = (vca::ShotDetector *) (detector);
+    shotDetector->push(epsilon);
+    return vca_result::VCA_OK;
+}
+
+DLL_PUBLIC bool vca_shot_detector_pop(vca_shot_detector *detector, vca_shot_detect_frame *frame)
+{
+    if (detector == nullptr || frame == nullptr)
+        return false;
+
+    auto shotDetector = (vca::ShotDetector *) (detector);
+    if (auto decidedFrame = shotDetector->pop())
+    {
+        *frame = *decidedFrame;
+        return true;
+    }
+    return false;
+}
+
+DLL_PUBLIC void vca_shot_detector_flush(vca_shot_detector *detector)
+{
+    if (detector == nullptr)
+        return;
+
+    auto shotDetector = (vca::ShotDetector *) (detector);
+    shotDetector->flush();
+}
+
+DLL_PUBLIC void vca_shot_detector_close(vca_shot_detector *detector)
+{
+    auto shotDetector = (vca::ShotDetector *) (detector);
+    delete shotDetector;
+}
+
 const char *vca_version_str = XSTR(VCA_VERSION);
@@ -56,7 +56,8 @@ enum class CpuSimd
     SSE2,
     SSSE3,
     SSE4,
-    AVX2
+    AVX2,
+    AVX512
 };
 
 struct vca_frame_texture_t
@@ -97,6 +98,24 @@ struct vca_frame_results
     unsigned jobID{};
 };
 
+/* A result that was borrowed using vca_analyzer_borrow_frame_result. The per block data is owned
+ * by the library. The energies are still read by the library to calculate the SAD of the next
+ * frame, so the data can only be read.
+ */
+struct vca_borrowed_frame_results
+{
+    const uint32_t *energyPerBlock{};
+    uint32_t averageEnergy{};
+
+    const uint32_t *sadPerBlock{};
+    double sad{};
+
+    double epsilon{};
+
+    int poc{};
+    unsigned jobID{};
+};
+
 struct vca_frame_info
 {
     unsigned width{};
@@ -132,11 +151,18 @@ struct vca_param
     // Size (width/height) of the analysis block. Must be 8, 16 or 32.
     unsigned blockSize{32};
 
+    // Number of worker threads. 0 means autodetect.
     unsigned nrFrameThreads{0};
+    // Split each frame into this many slices (ranges of block rows) which are analyzed in
+    // parallel by the worker threads. This reduces the latency per frame. 0 or 1 disables it.
     unsigned nrSliceThreads{0};
 
     CpuSimd cpuSimd{CpuSimd::Autodetect};
 
+    // Collect the timing statistics that can be read with vca_analyzer_get_stats.
+    // This adds a small overhead so it is disabled by default.
+    bool enableStats{false};
+
     void (*logFunction)(void *, LogLevel, const char *){};
     void *logFunctionPrivateData{};
 };
@@ -170,8 +196,77 @@ DLL_PUBLIC bool vca_result_available(vca_analyzer *enc);
  */
 DLL_PUBLIC vca_result vca_analyzer_pull_frame_result(vca_analyzer *enc, vca_frame_results *result);
 
+/* Pull a result from the analyzer without copying the per block data. This may block until a
+ * result is available. On success, result points to a result that is owned by the library.
+ * Its energyPerBlock and sadPerBlock point to the data of the library and stay valid until the
+ * result is given back using vca_analyzer_release_frame_result or the analyzer is closed.
+ */
+DLL_PUBLIC vca_result vca_analyzer_borrow_frame_result(vca_analyzer *enc,
+                                                       const vca_borrowed_frame_results **result);
+
+/* Give a result that was borrowed using vca_analyzer_borrow_frame_result back to the library.
+ * This may be called from any thread.
+ */
+DLL_PUBLIC void vca_analyzer_release_frame_result(vca_analyzer *enc,
+                                                  const vca_borrowed_frame_results *result);
+
 DLL_PUBLIC void vca_analyzer_close(vca_analyzer *enc);
 
+/* Statistics of an analyzer since it was opened. All times are cumulative nanoseconds.
+ * The stage times are summed over all worker threads.
+ */
+struct vca_analyzer_stats
+{
+    uint64_t frames{};
+    uint64_t jobs{};
+
+    // Time spent in the stages of the analysis. Kernels which transform and weight several 8x8
+    // blocks at once are counted in transformNs. copyNs is the time spent copying the blocks at
+    // the right and bottom border into a padded buffer. All other blocks are transformed
+    // directly from the frame.
+    uint64_t copyNs{};
+    uint64_t transformNs{};
+    uint64_t weightedSumNs{};
+    uint64_t sadNs{};
+
+    // Time that the calling threads waited in vca_analyzer_push (because the job queue was full)
+    // and in vca_analyzer_pull_frame_result / vca_analyzer_borrow_frame_result (because no
+    // result was ready). pullCopyNs is the time spent copying the per block data.
+    uint64_t pushWaitNs{};
+    uint64_t pullWaitNs{};
+    uint64_t pullCopyNs{};
+
+    // The current depth of the queues and the job queue depth sampled at each push
+    unsigned jobQueueDepth{};
+    unsigned resultQueueDepth{};
+    double averageJobQueueDepth{};
+    unsigned maxJobQueueDepth{};
+
+    unsigned nrThreads{};
+};
+
+/* Statistics of one worker thread. All times are cumulative nanoseconds.
+ */
+struct vca_thread_stats
+{
+    // Time spent working on jobs and waiting for the next job
+    uint64_t busyNs{};
+    uint64_t idleNs{};
+    uint64_t jobs{};
+};
+
+/* Get the statistics of the analyzer. The analyzer must have been opened with enableStats.
+ * This may be called from any thread at any time, so the values are only a snapshot.
+ */
+DLL_PUBLIC vca_result vca_analyzer_get_stats(vca_analyzer *enc, vca_analyzer_stats *stats);
+
+/* Get the statistics of the worker thread with the given index (less than nrThreads).
+ * The analyzer must have been opened with enableStats.
+ */
+DLL_PUBLIC vca_result vca_analyzer_get_thread_stats(vca_analyzer *enc,
+                                                    unsigned threadIndex,
+                                                    vca_thread_stats *stats);
+
 struct vca_shot_detection_param
 {
     double minEpsilonThresh{10};
@@ -179,6 +274,12 @@ struct vca_shot_detection_param
 
     double fps{};
 
+    // Only used by the vca_shot_detector. The maximum number of frames that a frame is held back
+    // while waiting for the next frame that is needed to decide it. If the limit is reached, the
+    // frame is not a new shot. 0 means no limit, which gives the same results as
+    // vca_shot_detection.
+    unsigned maxLookahead{0};
+
     void (*logFunction)(void *, LogLevel, const char *){};
     void *logFunctionPrivateData{};
 };
@@ -193,6 +294,31 @@ DLL_PUBLIC vca_result vca_shot_detection(const vca_shot_detection_param &param,
                                          vca_shot_detect_frame *frames,
                                          size_t num_frames);
 
+/* vca_shot_detector:
+ *      opaque handler for a shot detector that works on a stream of frames */
+typedef void vca_shot_detector;
+
+/* Create a new shot detector. It makes the same decisions as vca_shot_detection but the
+ * epsilon values are pushed one frame after another while the decisions can be popped
+ * as soon as they are made.
+ */
+DLL_PUBLIC vca_shot_detector *vca_shot_detector_open(vca_shot_detection_param param);
+
+/* Push the epsilon of the next frame.
+ */
+DLL_PUBLIC vca_result vca_shot_detector_push(vca_shot_detector *detector, double epsilon);
+
+/* Pop the decision for the next frame. Returns false if the next frame is not decided yet.
+ * Frames are popped in the order in which they were pushed.
+ */
+DLL_PUBLIC bool vca_shot_detector_pop(vca_shot_detector *detector, vca_shot_detect_frame *frame);
+
+/* Signal the end of the stream. After this, all frames that were pushed can be popped.
+ */
+DLL_PUBLIC void vca_shot_detector_flush(vca_shot_detector *detector);
+
+DLL_PUBLIC void vca_shot_detector_close(vca_shot_detector *detector);
+
 DLL_PUBLIC extern const char *vca_version_str;
 
 } // extern "C"